@@ -0,0 +1,826 @@
+// Benchmark harness for wxSimpleJSON.
+//
+// Generates synthetic documents and times parsing, traversal, building and
+// serialization. Each result is written as one JSON object per line (to stdout,
+// or the file given with --output) so that runs can be diffed across versions;
+// a readable summary goes to stderr.
+//
+// Usage: simplejson_bench [--size-mb N] [--iterations N] [--filter text]
+//                         [--label text] [--output file]
+//
+// frozen_read_threads reads one document from 64 threads at once; in a build
+// with -fsanitize=thread, "--filter frozen" doubles as a data race check.
+
+#include "wxSimpleJSON.h"
+#include "cJSON/cJSON.h"
+#include <wx/init.h>
+#include <wx/filename.h>
+#include <wx/wfstream.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __UNIX__
+#    include <sys/resource.h>
+#    include <sys/wait.h>
+#    include <unistd.h>
+#endif
+
+// Counts C++ heap allocations (wrappers, shared pointer control blocks,
+// strings and vectors); cJSON's own allocations are reflected in peak RSS.
+static std::atomic<size_t> s_allocations{ 0 };
+
+void *operator new(size_t size)
+{
+    ++s_allocations;
+    if (void *ptr = malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { free(ptr); }
+
+namespace
+{
+struct Options
+{
+    size_t m_sizeMB{ 16 };
+    size_t m_iterations{ 5 };
+    std::string m_filter;
+    std::string m_label{ "default" };
+    std::string m_output;
+};
+
+struct Result
+{
+    std::string m_benchmark;
+    std::string m_document;
+    size_t m_bytes{ 0 };
+    size_t m_ops{ 0 };
+    size_t m_iterations{ 0 };
+    double m_secondsMin{ 0 };
+    double m_secondsMean{ 0 };
+    size_t m_allocations{ 0 };
+    long m_peakRssKB{ -1 };
+};
+
+// ----------------------------------------------------------------------------
+// Document generators
+// ----------------------------------------------------------------------------
+
+// An object with many properties, mixing numbers and short strings.
+std::string MakeWideObject(size_t targetBytes, size_t &keyCount)
+{
+    std::string text{ "{" };
+    keyCount = 0;
+    while (text.length() < targetBytes) {
+        if (keyCount > 0) {
+            text += ",";
+        }
+        text += "\"key" + std::to_string(keyCount) + "\":";
+        text += (keyCount % 2) ? std::to_string(keyCount * 3) :
+                                 "\"value " + std::to_string(keyCount) + "\"";
+        ++keyCount;
+    }
+    text += "}";
+    return text;
+}
+
+// Records containing deeply nested objects and arrays.
+std::string MakeDeepDocument(size_t targetBytes)
+{
+    const size_t depth = 200;
+    std::string nested;
+    for (size_t i = 0; i < depth; ++i) {
+        nested += (i % 2) ? "[" : "{\"level\":" + std::to_string(i) + ",\"child\":";
+    }
+    nested += "\"leaf\"";
+    for (size_t i = depth; i > 0; --i) {
+        nested += ((i - 1) % 2) ? "]" : "}";
+    }
+    std::string text{ "[" };
+    while (text.length() < targetBytes) {
+        if (text.length() > 1) {
+            text += ",";
+        }
+        text += nested;
+    }
+    text += "]";
+    return text;
+}
+
+// A single large array of doubles.
+std::string MakeNumericArray(size_t targetBytes, size_t &count)
+{
+    std::mt19937 random(42);
+    std::uniform_real_distribution<double> values(-1e6, 1e6);
+    std::string text{ "{\"values\":[" };
+    char number[32];
+    count = 0;
+    while (text.length() < targetBytes) {
+        if (count > 0) {
+            text += ",";
+        }
+        snprintf(number, sizeof(number), "%.6f", values(random));
+        text += number;
+        ++count;
+    }
+    text += "]}";
+    return text;
+}
+
+// An array of strings with escapes and non-ASCII characters.
+std::string MakeStringArray(size_t targetBytes, size_t &count)
+{
+    static const char *samples[] = {
+        "plain ascii text for the benchmark",
+        "tab\\tseparated\\tvalues\\nand a newline",
+        "quotes \\\"inside\\\" and a back\\\\slash",
+        "unicode: caf\\u00e9 \\u4e2d\\u6587 \xc3\xbc\xc3\xb6\xc3\xa4",
+    };
+    std::string text{ "[" };
+    count = 0;
+    while (text.length() < targetBytes) {
+        if (count > 0) {
+            text += ",";
+        }
+        text += "\"";
+        text += samples[count % 4];
+        text += "\"";
+        ++count;
+    }
+    text += "]";
+    return text;
+}
+
+// Newline-delimited log records.
+std::string MakeRecords(size_t targetBytes, size_t &count)
+{
+    std::string text;
+    count = 0;
+    while (text.length() < targetBytes) {
+        text += "{\"id\":" + std::to_string(count) +
+                ",\"user\":\"user" + std::to_string(count % 1000) +
+                "\",\"bytes\":" + std::to_string((count * 7919) % 100000) +
+                ",\"ok\":" + ((count % 7) ? "true" : "false") +
+                ",\"tags\":[\"alpha\",\"beta\"]}\n";
+        ++count;
+    }
+    return text;
+}
+
+// ----------------------------------------------------------------------------
+// Measurement
+// ----------------------------------------------------------------------------
+
+long GetPeakRssKB()
+{
+#ifdef __UNIX__
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        // Linux reports kilobytes, macOS bytes
+#    ifdef __APPLE__
+        return usage.ru_maxrss / 1024;
+#    else
+        return usage.ru_maxrss;
+#    endif
+    }
+#endif
+    return -1;
+}
+
+// Runs a benchmark (in a child process where possible, so that each
+// benchmark gets its own peak RSS) and returns its timings.
+// The body is called once per iteration and returns the number of operations.
+Result Measure(const Options &options, const std::string &benchmark,
+               const std::string &document, size_t bytes,
+               const std::function<void()> &setup,
+               const std::function<size_t()> &body)
+{
+    Result result;
+    result.m_benchmark = benchmark;
+    result.m_document = document;
+    result.m_bytes = bytes;
+    result.m_iterations = options.m_iterations;
+
+    const auto run = [&]()
+        {
+        if (setup) {
+            setup();
+        }
+        double total{ 0 };
+        result.m_secondsMin = 0;
+        const size_t allocationsBefore = s_allocations;
+        for (size_t i = 0; i < options.m_iterations; ++i) {
+            const auto start = std::chrono::steady_clock::now();
+            result.m_ops = body();
+            const std::chrono::duration<double> elapsed =
+                std::chrono::steady_clock::now() - start;
+            total += elapsed.count();
+            if (i == 0 || elapsed.count() < result.m_secondsMin) {
+                result.m_secondsMin = elapsed.count();
+            }
+        }
+        result.m_secondsMean = total / options.m_iterations;
+        result.m_allocations = (s_allocations - allocationsBefore) / options.m_iterations;
+        result.m_peakRssKB = GetPeakRssKB();
+        };
+
+#ifdef __UNIX__
+    // the fields measured by the child, sent back to the parent through a pipe
+    struct Sample
+    {
+        double m_secondsMin;
+        double m_secondsMean;
+        size_t m_allocations;
+        size_t m_ops;
+        long m_peakRssKB;
+    };
+    int channel[2];
+    if (pipe(channel) == 0) {
+        fflush(nullptr);
+        const pid_t child = fork();
+        if (child == 0) {
+            close(channel[0]);
+            run();
+            const Sample sample{ result.m_secondsMin, result.m_secondsMean,
+                                 result.m_allocations, result.m_ops, result.m_peakRssKB };
+            const ssize_t written = write(channel[1], &sample, sizeof(sample));
+            _exit(written == static_cast<ssize_t>(sizeof(sample)) ? 0 : 1);
+        }
+        close(channel[1]);
+        if (child > 0) {
+            Sample sample{};
+            const ssize_t count = read(channel[0], &sample, sizeof(sample));
+            int status{ 0 };
+            waitpid(child, &status, 0);
+            close(channel[0]);
+            if (count == static_cast<ssize_t>(sizeof(sample))) {
+                result.m_secondsMin = sample.m_secondsMin;
+                result.m_secondsMean = sample.m_secondsMean;
+                result.m_allocations = sample.m_allocations;
+                result.m_ops = sample.m_ops;
+                result.m_peakRssKB = sample.m_peakRssKB;
+                return result;
+            }
+        }
+        else {
+            close(channel[0]);
+        }
+    }
+#endif
+    run();
+    return result;
+}
+
+void Report(FILE *output, const Options &options, const Result &result)
+{
+    const double mbPerSecond = (result.m_secondsMin > 0) ?
+        (result.m_bytes / (1024.0 * 1024.0)) / result.m_secondsMin : 0;
+    const double opsPerSecond = (result.m_secondsMin > 0) ?
+        result.m_ops / result.m_secondsMin : 0;
+    fprintf(output,
+            "{\"label\":\"%s\",\"benchmark\":\"%s\",\"document\":\"%s\",\"bytes\":%zu,"
+            "\"iterations\":%zu,\"seconds_min\":%.6f,\"seconds_mean\":%.6f,"
+            "\"mb_per_s\":%.2f,\"ops\":%zu,\"ops_per_s\":%.0f,"
+            "\"cpp_allocations\":%zu,\"peak_rss_kb\":%ld}\n",
+            options.m_label.c_str(), result.m_benchmark.c_str(), result.m_document.c_str(),
+            result.m_bytes, result.m_iterations, result.m_secondsMin, result.m_secondsMean,
+            mbPerSecond, result.m_ops, opsPerSecond, result.m_allocations, result.m_peakRssKB);
+    fflush(output);
+    fprintf(stderr, "%-28s %-8s %10.2f MB/s %14.0f ops/s %10ld KB peak\n",
+            result.m_benchmark.c_str(), result.m_document.c_str(),
+            mbPerSecond, opsPerSecond, result.m_peakRssKB);
+}
+
+bool ParseArguments(int argc, char **argv, Options &options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg{ argv[i] };
+        const bool hasValue = (i + 1 < argc);
+        if (arg == "--size-mb" && hasValue) {
+            options.m_sizeMB = std::max<size_t>(1, strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--iterations" && hasValue) {
+            options.m_iterations = std::max<size_t>(1, strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--filter" && hasValue) {
+            options.m_filter = argv[++i];
+        }
+        else if (arg == "--label" && hasValue) {
+            options.m_label = argv[++i];
+        }
+        else if (arg == "--output" && hasValue) {
+            options.m_output = argv[++i];
+        }
+        else {
+            fprintf(stderr, "usage: %s [--size-mb N] [--iterations N] [--filter text] "
+                            "[--label text] [--output file]\n", argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// A record of MakeRecords(), for the binding benchmarks.
+struct Record
+{
+    int64_t m_id{ 0 };
+    wxString m_user;
+    double m_bytes{ 0 };
+    bool m_ok{ false };
+    std::vector<wxString> m_tags;
+};
+}
+
+WX_SIMPLE_JSON_BIND_BEGIN(Record)
+    WX_SIMPLE_JSON_FIELD_NAMED(m_id, "id")
+    WX_SIMPLE_JSON_FIELD_NAMED(m_user, "user")
+    WX_SIMPLE_JSON_FIELD_NAMED(m_bytes, "bytes")
+    WX_SIMPLE_JSON_FIELD_NAMED(m_ok, "ok")
+    WX_SIMPLE_JSON_FIELD_NAMED(m_tags, "tags")
+WX_SIMPLE_JSON_BIND_END()
+
+int main(int argc, char **argv)
+{
+    wxInitializer initializer;
+    if (!initializer.IsOk()) {
+        fprintf(stderr, "Failed to initialize wxWidgets.\n");
+        return EXIT_FAILURE;
+    }
+
+    Options options;
+    if (!ParseArguments(argc, argv, options)) {
+        return EXIT_FAILURE;
+    }
+    FILE *output = stdout;
+    if (!options.m_output.empty()) {
+        output = fopen(options.m_output.c_str(), "w");
+        if (output == nullptr) {
+            fprintf(stderr, "Cannot open %s\n", options.m_output.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+
+    const size_t targetBytes = options.m_sizeMB * 1024 * 1024;
+    size_t keyCount{ 0 }, numberCount{ 0 }, stringCount{ 0 };
+    struct Document
+    {
+        std::string m_name;
+        std::string m_text;
+        wxString m_path;
+    };
+    std::vector<Document> documents{
+        { "wide", MakeWideObject(targetBytes, keyCount), wxString() },
+        { "deep", MakeDeepDocument(targetBytes), wxString() },
+        { "numeric", MakeNumericArray(targetBytes, numberCount), wxString() },
+        { "strings", MakeStringArray(targetBytes, stringCount), wxString() }
+    };
+    for (auto &document : documents) {
+        document.m_path = wxFileName::CreateTempFileName("simplejson_bench");
+        FILE *fp = fopen(document.m_path.mb_str().data(), "wb");
+        if (fp == nullptr ||
+            fwrite(document.m_text.data(), 1, document.m_text.length(), fp) !=
+                document.m_text.length()) {
+            fprintf(stderr, "Cannot write %s\n", document.m_path.mb_str().data());
+            return EXIT_FAILURE;
+        }
+        fclose(fp);
+    }
+
+    const auto wanted = [&options](const std::string &name)
+        {
+        return (options.m_filter.empty() || name.find(options.m_filter) != std::string::npos);
+        };
+    const auto bench = [&](const std::string &name, const Document &document,
+                           const std::function<void()> &setup,
+                           const std::function<size_t()> &body)
+        {
+        if (wanted(name)) {
+            Report(output, options,
+                   Measure(options, name, document.m_name, document.m_text.length(),
+                           setup, body));
+        }
+        };
+
+    wxSimpleJSON::ParseOptions arena;
+    arena.useArena = true;
+    wxSimpleJSON::ParseOptions parallel;
+    parallel.threads = 0;
+    wxSimpleJSON::ParseOptions lazy;
+    lazy.lazy = true;
+    wxSimpleJSON::Ptr_t parsed;
+    const wxString tempSave = wxFileName::CreateTempFileName("simplejson_bench");
+
+    for (const auto &document : documents) {
+        const std::string &text = document.m_text;
+        const wxString wideText = wxString::FromUTF8(text.data(), text.length());
+
+        // parsing (cJSON on its own is the baseline for the library's parser)
+        bench("parse_cjson", document, nullptr, [&]()
+            {
+            cJSON *root = cJSON_ParseWithLength(text.data(), text.length());
+            cJSON_Delete(root);
+            return root != nullptr ? 1 : 0;
+            });
+        bench("parse_wxstring", document, nullptr, [&]()
+            { return wxSimpleJSON::Create(wideText, true)->IsOk() ? 1 : 0; });
+        bench("parse_utf8", document, nullptr, [&]()
+            { return wxSimpleJSON::CreateFromUTF8(text.data(), text.length(), true)->IsOk() ? 1 : 0; });
+        // the same with statistics on (their cost when enabled)
+        bench("parse_utf8_statistics", document, nullptr, [&]()
+            {
+            wxSimpleJSON::EnableStatistics();
+            const bool ok = wxSimpleJSON::CreateFromUTF8(text.data(), text.length(), true)->IsOk();
+            wxSimpleJSON::EnableStatistics(false);
+            return ok ? 1 : 0;
+            });
+        bench("parse_utf8_arena", document, nullptr, [&]()
+            { return wxSimpleJSON::CreateFromUTF8(text.data(), text.length(), arena)->IsOk() ? 1 : 0; });
+        // parsing into a reused document (allocates nothing once it has warmed up)
+        wxSimpleJSON::Document reusable;
+        bench("parse_utf8_reuse", document, nullptr, [&]()
+            { return reusable.Parse(text.data(), text.length())->IsOk() ? 1 : 0; });
+        bench("parse_utf8_parallel", document, nullptr, [&]()
+            { return wxSimpleJSON::CreateFromUTF8(text.data(), text.length(), parallel)->IsOk() ? 1 : 0; });
+        bench("load_file", document, nullptr, [&]()
+            { return wxSimpleJSON::LoadFile(wxFileName(document.m_path))->IsOk() ? 1 : 0; });
+        bench("load_file_arena", document, nullptr, [&]()
+            { return wxSimpleJSON::LoadFile(wxFileName(document.m_path), arena)->IsOk() ? 1 : 0; });
+        // loading lazily and reading the first item (time to first value)
+        bench("load_file_lazy", document, nullptr, [&]()
+            {
+            const auto json = wxSimpleJSON::LoadFile(wxFileName(document.m_path), lazy);
+            return (json->GetView().begin() != json->GetView().end()) ? 1 : 0;
+            });
+
+        // the same document as CBOR and compiled (checking that they read back as the same values)
+        const auto reference = wxSimpleJSON::CreateFromUTF8(text.data(), text.length(), true);
+        const std::string referenceText = reference->PrintUTF8(false);
+        std::string binary;
+        reference->WriteBinary(binary);
+        if (wxSimpleJSON::CreateFromBinary(binary.data(), binary.length())->PrintUTF8(false) !=
+            referenceText) {
+            fprintf(stderr, "CBOR round trip of %s failed\n", document.m_name.c_str());
+        }
+        const wxString compiledPath = wxFileName::CreateTempFileName("simplejson_bench");
+        if (!reference->SaveCompiled(wxFileName(compiledPath)) ||
+            wxSimpleJSON::MapFile(wxFileName(compiledPath)).PrintUTF8(false) != referenceText) {
+            fprintf(stderr, "Compiled round trip of %s failed\n", document.m_name.c_str());
+        }
+        const wxString binaryPath = wxFileName::CreateTempFileName("simplejson_bench");
+        wxFFile binaryFile(binaryPath, "wb");
+        binaryFile.Write(binary.data(), binary.length());
+        binaryFile.Close();
+        bench("parse_binary", document, nullptr, [&]()
+            { return wxSimpleJSON::CreateFromBinary(binary.data(), binary.length())->IsOk() ? 1 : 0; });
+        bench("load_binary", document, nullptr, [&]()
+            { return wxSimpleJSON::LoadBinary(wxFileName(binaryPath))->IsOk() ? 1 : 0; });
+        // mapping the compiled document and reading its first item (time to first value)
+        bench("map_file", document, nullptr, [&]()
+            {
+            const auto json = wxSimpleJSON::MapFile(wxFileName(compiledPath));
+            return (json.begin() != json.end()) ? 1 : 0;
+            });
+
+        // serializing
+        const auto parse = [&]()
+            { parsed = wxSimpleJSON::CreateFromUTF8(text.data(), text.length(), true); };
+        bench("print_pretty", document, parse, [&]()
+            { return parsed->Print(true).length() > 0 ? 1 : 0; });
+        bench("print_compact", document, parse, [&]()
+            { return parsed->Print(false).length() > 0 ? 1 : 0; });
+        bench("print_utf8_compact", document, parse, [&]()
+            { return parsed->PrintUTF8(false).length() > 0 ? 1 : 0; });
+        std::string printed;
+        bench("print_utf8_compact_reuse", document, parse, [&]()
+            { return parsed->PrintUTF8(printed, false) ? 1 : 0; });
+        bench("save", document, parse, [&]()
+            { return parsed->Save(wxFileName(tempSave)) ? 1 : 0; });
+        bench("save_binary", document, parse, [&]()
+            { return parsed->SaveBinary(wxFileName(tempSave)) ? 1 : 0; });
+        wxRemoveFile(binaryPath);
+        wxRemoveFile(compiledPath);
+        // re-printing after a small edit, with and without the print cache
+        size_t edits{ 0 };
+        const auto edit = [&]()
+            {
+            if (parsed->IsValueObject()) {
+                parsed->Add("edited", static_cast<double>(++edits));
+            }
+            else if (parsed->ArraySize() > 0) {
+                parsed->DeleteProperty(static_cast<int>(parsed->ArraySize() - 1));
+                parsed->ArrayAdd(static_cast<double>(++edits));
+            }
+            };
+        bench("print_compact_after_edit", document, parse, [&]()
+            {
+            edit();
+            return parsed->PrintUTF8(false).length() > 0 ? 1 : 0;
+            });
+        bench("print_compact_after_edit_cached", document,
+            [&]()
+            {
+            parse();
+            parsed->EnablePrintCache();
+            parsed->PrintUTF8(false);
+            },
+            [&]()
+            {
+            edit();
+            return parsed->PrintUTF8(false).length() > 0 ? 1 : 0;
+            });
+    }
+
+    // traversal
+    const Document &wide = documents[0];
+    const size_t lookups = 100000;
+    std::vector<wxString> keys;
+    std::mt19937 random(42);
+    std::uniform_int_distribution<size_t> keyIndex(0, keyCount - 1);
+    for (size_t i = 0; i < 1000; ++i) {
+        keys.push_back(wxString::Format("key%d", static_cast<int>(keyIndex(random))));
+    }
+    const auto parseWide = [&]()
+        { parsed = wxSimpleJSON::CreateFromUTF8(wide.m_text.data(), wide.m_text.length(), true); };
+    bench("get_property", wide, parseWide, [&]()
+        {
+        size_t found{ 0 };
+        for (size_t i = 0; i < lookups / 100; ++i) {
+            found += parsed->GetProperty(keys[i % keys.size()])->IsOk() ? 1 : 0;
+        }
+        return found;
+        });
+    bench("get_property_view", wide, parseWide, [&]()
+        {
+        const auto root = parsed->GetView();
+        size_t found{ 0 };
+        for (size_t i = 0; i < lookups / 100; ++i) {
+            found += root.GetProperty(keys[i % keys.size()]).IsOk() ? 1 : 0;
+        }
+        return found;
+        });
+    bench("get_property_indexed", wide, [&]() { parseWide(); parsed->BuildIndex(); }, [&]()
+        {
+        size_t found{ 0 };
+        for (size_t i = 0; i < lookups; ++i) {
+            found += parsed->GetProperty(keys[i % keys.size()])->IsOk() ? 1 : 0;
+        }
+        return found;
+        });
+
+    const Document &deep = documents[1];
+    bench("get_property_chain", deep,
+        [&]() { parsed = wxSimpleJSON::CreateFromUTF8(deep.m_text.data(), deep.m_text.length(), true); },
+        [&]()
+        {
+        size_t steps{ 0 };
+        for (size_t i = 0; i < 100; ++i) {
+            auto node = parsed->Item(0);
+            while (node->IsOk()) {
+                node = node->IsValueArray() ? node->Item(0) : node->GetProperty("child");
+                ++steps;
+            }
+        }
+        return steps;
+        });
+
+    // the pointer to the innermost value of the first nested document
+    std::string deepPointer{ "/0" };
+    for (size_t i = 0; i < 200; ++i) {
+        deepPointer += (i % 2) ? "/0" : "/child";
+    }
+    const wxString deepPointerString(deepPointer);
+    bench("get_path", deep,
+        [&]() { parsed = wxSimpleJSON::CreateFromUTF8(deep.m_text.data(), deep.m_text.length(), true); },
+        [&]()
+        {
+        size_t found{ 0 };
+        for (size_t i = 0; i < 100; ++i) {
+            found += parsed->At(deepPointerString)->IsOk() ? 1 : 0;
+        }
+        return found;
+        });
+    const wxSimpleJSON::Path deepPath(deepPointer.c_str());
+    bench("get_path_compiled", deep,
+        [&]() { parsed = wxSimpleJSON::CreateFromUTF8(deep.m_text.data(), deep.m_text.length(), true); },
+        [&]()
+        {
+        const auto root = parsed->GetView();
+        size_t found{ 0 };
+        for (size_t i = 0; i < 100; ++i) {
+            found += root.At(deepPath).IsOk() ? 1 : 0;
+        }
+        return found;
+        });
+
+    // sharing a frozen document between threads: each reader walks its own
+    // records through child handles, looking values up and printing a subtree
+    const unsigned int readerThreads = 64;
+    wxSimpleJSON::FrozenNode frozen;
+    bench("frozen_read_threads", deep,
+        [&]()
+        {
+        frozen = wxSimpleJSON::CreateFromUTF8(deep.m_text.data(),
+                                              deep.m_text.length(), true)->Freeze();
+        },
+        [&]()
+        {
+        std::atomic<size_t> steps{ 0 };
+        const size_t records = frozen.ArraySize();
+        std::vector<std::thread> readers;
+        for (unsigned int reader = 0; reader < readerThreads; ++reader) {
+            readers.emplace_back([&, reader]()
+                {
+                size_t readerSteps{ 0 };
+                for (size_t i = 0; i < 10; ++i) {
+                    auto node = frozen.Item((reader * 10 + i) % records);
+                    for (size_t depth = 0; node.IsOk(); ++depth, ++readerSteps) {
+                        if (depth == 150) {
+                            readerSteps += node.PrintUTF8(false).empty() ? 0 : 1;
+                        }
+                        node = (node.GetType() == wxSimpleJSON::IS_ARRAY) ?
+                            node.Item(0) : node.GetProperty("child");
+                    }
+                }
+                steps += readerSteps;
+                });
+        }
+        for (auto &thread : readers) {
+            thread.join();
+        }
+        return steps.load();
+        });
+
+    const Document &numeric = documents[2];
+    bench("get_value_array_number", numeric,
+        [&]() { parsed = wxSimpleJSON::CreateFromUTF8(numeric.m_text.data(), numeric.m_text.length(), true); },
+        [&]() { return parsed->GetProperty("values")->GetValueArrayNumber().size(); });
+    std::vector<double> numbers;
+    bench("copy_array_number", numeric,
+        [&]() { parsed = wxSimpleJSON::CreateFromUTF8(numeric.m_text.data(), numeric.m_text.length(), true); },
+        [&]() { return parsed->GetView().GetProperty("values").CopyArrayTo(numbers); });
+
+    const Document &strings = documents[3];
+    bench("get_value_array_string", strings,
+        [&]() { parsed = wxSimpleJSON::CreateFromUTF8(strings.m_text.data(), strings.m_text.length(), true); },
+        [&]() { return parsed->GetValueArrayString().size(); });
+    bench("get_value_array_string_utf8", strings,
+        [&]() { parsed = wxSimpleJSON::CreateFromUTF8(strings.m_text.data(), strings.m_text.length(), true); },
+        [&]() { return parsed->GetValueArrayStringUTF8().size(); });
+
+    // building
+    std::vector<wxString> names;
+    for (size_t i = 0; i < 50000; ++i) {
+        names.push_back(wxString::Format("key%d", static_cast<int>(i)));
+    }
+    bench("build_add", wide, nullptr, [&]()
+        {
+        auto root = wxSimpleJSON::Create(wxSimpleJSON::IS_OBJECT, true);
+        for (size_t i = 0; i < names.size() / 10; ++i) {
+            root->Add(names[i], static_cast<double>(i));
+        }
+        return names.size() / 10;
+        });
+    bench("build_add_unique", wide, nullptr, [&]()
+        {
+        auto root = wxSimpleJSON::Create(wxSimpleJSON::IS_OBJECT, true);
+        for (size_t i = 0; i < names.size(); ++i) {
+            root->AddUnique(names[i], static_cast<double>(i));
+        }
+        return names.size();
+        });
+    bench("build_array", numeric, nullptr, [&]()
+        {
+        auto root = wxSimpleJSON::Create(wxSimpleJSON::IS_ARRAY, true);
+        for (size_t i = 0; i < numberCount; ++i) {
+            root->ArrayAdd(static_cast<double>(i));
+        }
+        return numberCount;
+        });
+    std::vector<double> series(numberCount);
+    for (size_t i = 0; i < numberCount; ++i) {
+        series[i] = static_cast<double>(i);
+    }
+    bench("build_array_bulk", numeric, nullptr, [&]()
+        {
+        auto root = wxSimpleJSON::Create(wxSimpleJSON::IS_OBJECT, true);
+        root->Add("values", series);
+        return numberCount;
+        });
+
+    // newline-delimited records
+    size_t recordCount{ 0 };
+    Document records{ "records", MakeRecords(targetBytes, recordCount),
+                      wxFileName::CreateTempFileName("simplejson_bench") };
+    wxFFile recordFile(records.m_path, "wb");
+    recordFile.Write(records.m_text.data(), records.m_text.length());
+    recordFile.Close();
+    const auto readRecords = [&](bool reuseNodes)
+        {
+        wxSimpleJSON::NDJSONReader reader{ wxFileName(records.m_path), reuseNodes };
+        wxSimpleJSON::Ptr_t record;
+        size_t count{ 0 };
+        while (reader.Next(record)) {
+            count += record->IsOk() ? 1 : 0;
+        }
+        return count;
+        };
+    bench("ndjson_read", records, nullptr, [&]() { return readRecords(false); });
+    bench("ndjson_read_reuse", records, nullptr, [&]() { return readRecords(true); });
+    bench("ndjson_read_batch", records, nullptr, [&]()
+        {
+        wxSimpleJSON::NDJSONReader reader{ wxFileName(records.m_path) };
+        std::vector<wxSimpleJSON::Ptr_t> batch;
+        size_t count{ 0 };
+        while (reader.NextBatch(batch, 10000) > 0) {
+            count += batch.size();
+        }
+        return count;
+        });
+    bench("ndjson_write", records,
+        [&]()
+        {
+        parsed = wxSimpleJSON::CreateFromUTF8(records.m_text.data(), records.m_text.find('\n'), true);
+        },
+        [&]()
+        {
+        wxFFileOutputStream out(tempSave);
+        wxSimpleJSON::NDJSONWriter writer(out);
+        for (size_t i = 0; i < recordCount; ++i) {
+            writer.Write(*parsed);
+        }
+        return writer.Flush() ? recordCount : 0;
+        });
+
+    // reading the records into structs through a binding, and property by property
+    std::string recordArray{ "[" + records.m_text + "]" };
+    std::replace(recordArray.begin() + 1, recordArray.end() - 2, '\n', ',');
+    recordArray.erase(recordArray.length() - 2, 1);
+    const auto parseRecords = [&]()
+        { parsed = wxSimpleJSON::CreateFromUTF8(recordArray.data(), recordArray.length(), true); };
+    std::vector<Record> bound;
+    bench("bind_to", records, parseRecords, [&]()
+        {
+        bound.clear();
+        for (const auto &item : parsed->GetView()) {
+            bound.push_back(item.To<Record>());
+        }
+        return bound.size();
+        });
+    bench("bind_manual", records, parseRecords, [&]()
+        {
+        bound.clear();
+        for (const auto &item : *parsed) {
+            Record record;
+            record.m_id = static_cast<int64_t>(item.GetProperty("id")->GetValueNumber());
+            record.m_user = item.GetProperty("user")->GetValueString();
+            record.m_bytes = item.GetProperty("bytes")->GetValueNumber();
+            record.m_ok = item.GetProperty("ok")->GetValueBool();
+            const wxArrayString tags = item.GetProperty("tags")->GetValueArrayString();
+            for (size_t i = 0; i < tags.GetCount(); ++i) {
+                record.m_tags.push_back(tags.Item(i));
+            }
+            bound.push_back(record);
+        }
+        return bound.size();
+        });
+    // checking the records against a schema
+    const std::string recordSchema{ "{\"type\":\"array\",\"items\":{\"type\":\"object\","
+        "\"required\":[\"id\",\"user\",\"bytes\",\"ok\"],\"additionalProperties\":false,"
+        "\"properties\":{\"id\":{\"type\":\"integer\",\"minimum\":0},\"user\":{\"type\":\"string\"},"
+        "\"bytes\":{\"type\":\"number\"},\"ok\":{\"type\":\"boolean\"},"
+        "\"tags\":{\"type\":\"array\",\"items\":{\"type\":\"string\"}}}}}" };
+    const wxSimpleJSON::Schema schema(
+        wxSimpleJSON::CreateFromUTF8(recordSchema.data(), recordSchema.length(), true)->GetView());
+    bench("validate", records, parseRecords, [&]()
+        { return parsed->Validate(schema) ? recordCount : 0; });
+    bench("bind_from", records, nullptr, [&]()
+        {
+        size_t count{ 0 };
+        for (const auto &record : bound) {
+            count += wxSimpleJSON::From(record)->IsOk() ? 1 : 0;
+        }
+        return count;
+        });
+    documents.push_back(records);
+
+    for (const auto &document : documents) {
+        wxRemoveFile(document.m_path);
+    }
+    wxRemoveFile(tempSave);
+    if (output != stdout) {
+        fclose(output);
+    }
+    return EXIT_SUCCESS;
+}
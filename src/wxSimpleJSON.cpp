@@ -1,387 +1,6299 @@
 #include "wxSimpleJSON.h"
 #include "cJSON/cJSON.h"
+#include <type_traits>
+#include <algorithm>
+#include <cstring>
+#include <clocale>
+#include <cmath>
+#include <cfloat>
+#include <cstdlib>
+#include <cctype>
+#include <climits>
+#include <cstdint>
+#include <unordered_map>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#if defined(__UNIX__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#elif defined(__WINDOWS__)
+    #include <wx/msw/wrapwin.h>
+#endif
 
-static cJSON *cJSONAllocNew()
-{
-    cJSON *node = (cJSON *)malloc(sizeof(cJSON));
-    if(node) memset(node, 0, sizeof(cJSON));
-    return node;
-}
-
-wxSimpleJSON::wxSimpleJSON()
-    : m_d(NULL)
-    , m_canDelete(false)
-{
-}
-
-wxSimpleJSON::~wxSimpleJSON() {}
+static_assert(std::is_trivially_copyable<wxSimpleJSON::View>::value,
+              "wxSimpleJSON::View must stay a plain value type");
 
-wxSimpleJSON::Ptr_t wxSimpleJSON::Create(wxSimpleJSON::JSONType type, bool isRoot)
+// Returns true if text in this encoding can be given to cJSON without converting it.
+static bool IsUTF8Conv(const wxMBConv &conv)
 {
-    wxSimpleJSON *obj = new wxSimpleJSON();
-    obj->m_d = cJSONAllocNew();
-    obj->m_d->type = static_cast<int>(type);
-    obj->m_canDelete = isRoot;
-    wxSimpleJSON::Ptr_t ptr(obj, wxSimpleJSON::Destroy);
-    return ptr;
+    return (&conv == &wxConvUTF8 ||
+            dynamic_cast<const wxMBConvStrictUTF8 *>(&conv) != nullptr ||
+            dynamic_cast<const wxMBConvUTF8 *>(&conv) != nullptr);
 }
 
-wxSimpleJSON::Ptr_t wxSimpleJSON::Create(cJSON *p, bool canDelete)
+// Builds the (human readable) error message for a failed parse, where
+// parseEnd is where the parser stopped (column bytes into the line lineCount
+// lines into the text), lineBegin is where the quoted part of that line starts
+// and the available text ends at end.
+static wxString FormatParseError(size_t lineCount, size_t column, const char *lineBegin,
+                                 const char *parseEnd, const char *end,
+                                 const wxMBConv &conv)
 {
-    wxSimpleJSON *obj = new wxSimpleJSON();
-    obj->m_d = p;
-    obj->m_canDelete = canDelete;
-    wxSimpleJSON::Ptr_t ptr(obj, wxSimpleJSON::Destroy);
-    return ptr;
+    auto endOfErrorLine = parseEnd;
+    while (endOfErrorLine < end && *endOfErrorLine != 0 && *endOfErrorLine != '\n') {
+        ++endOfErrorLine;
+        if (endOfErrorLine < end && *endOfErrorLine == '\n') {
+            --endOfErrorLine;
+            break;
+            }
+        }
+    // get the text where the error occurred
+    wxString errorLine(lineBegin, conv, endOfErrorLine-lineBegin);
+    wxString errorLineStartOfError(parseEnd, conv, endOfErrorLine-parseEnd);
+    return wxString::Format(_(L"JSON parsing error at line %s, column %s.\n\n"
+                               "full line:\n%s\n\n"
+                               "start of error:\n%s"),
+        wxNumberFormatter::ToString(static_cast<long>(lineCount) + 1 /* human readable 1 indexed*/, 0,
+                                    wxNumberFormatter::Style::Style_WithThousandsSep),
+        wxNumberFormatter::ToString(static_cast<long>(column) + 1 /* human readable 1 indexed*/, 0,
+                                    wxNumberFormatter::Style::Style_WithThousandsSep),
+        errorLine, errorLineStartOfError);
 }
 
-void wxSimpleJSON::Destroy(wxSimpleJSON *obj)
+// Builds the error message for a failed parse, where parseEnd is
+// where the parser stopped in [begin, end).
+static wxString FormatParseError(const char *begin, const char *end,
+                                 const char *parseEnd, const wxMBConv &conv)
 {
-    if(obj->m_canDelete && obj->m_d) {
-        cJSON_Delete(obj->m_d);
+    if (parseEnd == nullptr || parseEnd < begin || parseEnd > end) {
+        parseEnd = begin;
     }
-    obj->m_d = nullptr;
-    wxDELETE(obj);
+    const auto lineCount = std::count(begin, parseEnd, '\n');
+    // get the full line where the error occurred
+    auto startOfErrorLine = parseEnd;
+    while (startOfErrorLine > begin && *startOfErrorLine != '\n') {
+        --startOfErrorLine;
+        if (*startOfErrorLine == '\n') {
+            ++startOfErrorLine;
+            break;
+            }
+        }
+    return FormatParseError(lineCount, parseEnd - startOfErrorLine, startOfErrorLine,
+                            parseEnd, end, conv);
 }
 
-wxSimpleJSON &wxSimpleJSON::ArrayAdd(wxSimpleJSON::Ptr_t obj)
-{
-    cJSON_AddItemToArray(m_d, obj->m_d);
-    return *this;
-}
+// Flags a node of a lazy document (see ParseOptions::lazy) whose text hasn't
+// been parsed yet. It has no child, and its valuestring points to a LazyText.
+static const int cJSON_IsLazy = 1 << 12;
 
-wxSimpleJSON &wxSimpleJSON::ArrayAdd(const wxString &value, const wxMBConv &conv)
+// A node's type, without the flags that can be set along with it
+// (cJSON_IsReference, cJSON_StringIsConst and cJSON_IsLazy).
+static inline int NodeType(const cJSON *node)
 {
-    cJSON_AddItemToArray(m_d, cJSON_CreateString(value.mb_str(conv).data()));
-    return *this;
+    return (node->type & 0xFF);
 }
 
-wxSimpleJSON &wxSimpleJSON::ArrayAdd(double value)
+static void MaterializeNode(cJSON *node);
+static void MaterializeTree(cJSON *node);
+
+// Parses a lazy node's text, unless that's been done already.
+static inline cJSON *Materialize(cJSON *node)
 {
-    cJSON_AddItemToArray(m_d, cJSON_CreateNumber(value));
-    return *this;
+    if (node != nullptr && (node->type & cJSON_IsLazy)) {
+        MaterializeNode(node);
+    }
+    return node;
 }
 
-wxSimpleJSON &wxSimpleJSON::Add(const wxString &name, wxSimpleJSON::Ptr_t obj)
+// Statistics (see EnableStatistics())
+
+enum StatisticId
 {
-    DeleteProperty(name);
+    NodesCreated,
+    HandlesCreated,
+    Parses,
+    BytesParsed,
+    ParseNanoseconds,
+    Prints,
+    BytesPrinted,
+    PrintNanoseconds,
+    KeyScanSteps,
+    Transcodes,
+    TranscodedBytes,
+    Allocations,
+    AllocatedBytes,
+    Frees,
+    StatisticCount
+};
 
-    cJSON_AddItemToObject(m_d, name.mb_str(wxConvUTF8).data(), obj->m_d);
-    return *this;
-}
+static std::atomic<bool> s_statisticsEnabled{ false };
 
-wxSimpleJSON &wxSimpleJSON::Add(const wxString &name, const wxString &value, const wxMBConv &conv)
+static inline bool StatisticsEnabled()
 {
-    DeleteProperty(name);
-
-    cJSON_AddStringToObject(m_d, name.mb_str(wxConvUTF8).data(), value.mb_str(conv).data());
-    return *this;
+    return s_statisticsEnabled.load(std::memory_order_relaxed);
 }
 
-wxSimpleJSON &wxSimpleJSON::Add(const wxString &name, double value)
+// One thread's counters. Only the thread itself changes them (so counting needs no
+// locked instructions), and GetStatistics() adds up every thread's.
+struct ThreadStatistics
 {
-    DeleteProperty(name);
+    ThreadStatistics();
+    ~ThreadStatistics();
+    ThreadStatistics(const ThreadStatistics&) = delete;
+    ThreadStatistics& operator=(const ThreadStatistics&) = delete;
 
-    cJSON_AddNumberToObject(m_d, name.mb_str(wxConvUTF8).data(), value);
-    return *this;
-}
+    std::atomic<uint64_t> m_counters[StatisticCount];
+};
 
-wxSimpleJSON &wxSimpleJSON::AddNull(const wxString &name)
+// The counters of the threads that are running, and what the others counted.
+struct StatisticsRegistry
 {
-    DeleteProperty(name);
+    std::mutex m_mutex;
+    std::vector<ThreadStatistics *> m_threads;
+    uint64_t m_finished[StatisticCount]{ 0 };
+    // the totals at the last ResetStatistics()
+    uint64_t m_baseline[StatisticCount]{ 0 };
+};
 
-    cJSON_AddNullToObject(m_d, name.mb_str(wxConvUTF8).data());
-    return *this;
+static StatisticsRegistry &GetStatisticsRegistry()
+{
+    // never destroyed, since threads can finish after static destructors have run
+    static StatisticsRegistry *registry = new StatisticsRegistry;
+    return *registry;
 }
 
-wxSimpleJSON &wxSimpleJSON::ArrayAdd(const wxArrayString &arr, const wxMBConv &conv)
+ThreadStatistics::ThreadStatistics()
 {
-    wxSimpleJSON::Ptr_t parr = Create(wxSimpleJSON::IS_ARRAY);
-    for(size_t i = 0; i < arr.size(); ++i) {
-        parr->ArrayAdd(arr.Item(i), conv);
+    for (auto &counter : m_counters) {
+        counter.store(0, std::memory_order_relaxed);
     }
-    return ArrayAdd(parr);
+    StatisticsRegistry &registry = GetStatisticsRegistry();
+    std::lock_guard<std::mutex> lock(registry.m_mutex);
+    registry.m_threads.push_back(this);
 }
 
-wxSimpleJSON &wxSimpleJSON::Add(const wxString &name, const wxArrayString &arr, const wxMBConv &conv)
+ThreadStatistics::~ThreadStatistics()
 {
-    DeleteProperty(name);
-
-    wxSimpleJSON::Ptr_t parr = Create(wxSimpleJSON::IS_ARRAY);
-    for(size_t i = 0; i < arr.size(); ++i) {
-        parr->ArrayAdd(arr.Item(i), conv);
+    StatisticsRegistry &registry = GetStatisticsRegistry();
+    std::lock_guard<std::mutex> lock(registry.m_mutex);
+    for (size_t i = 0; i < StatisticCount; ++i) {
+        registry.m_finished[i] += m_counters[i].load(std::memory_order_relaxed);
     }
-    return Add(name, parr);
+    registry.m_threads.erase(
+        std::find(registry.m_threads.begin(), registry.m_threads.end(), this));
 }
 
-size_t wxSimpleJSON::ArraySize() const { return cJSON_GetArraySize(m_d); }
+static thread_local ThreadStatistics t_statistics;
 
-wxSimpleJSON::Ptr_t wxSimpleJSON::Item(size_t index) const
+// Adds amount to a counter, if counting is on.
+static inline void CountStatistic(StatisticId id, uint64_t amount = 1)
 {
-    cJSON* item{ nullptr };
-    if(!m_d || (m_d->type != cJSON_Array)) {
-        return Create(item);
+    if (StatisticsEnabled()) {
+        std::atomic<uint64_t> &counter = t_statistics.m_counters[id];
+        counter.store(counter.load(std::memory_order_relaxed) + amount,
+                      std::memory_order_relaxed);
     }
-    item = cJSON_GetArrayItem(m_d, index);
-    return Create(item);
 }
 
-wxString wxSimpleJSON::GetValueString(const wxString &defaultValue,
-                                      const wxMBConv &conv) const
+// Counts an operation (a parse or print) that lasts while in scope, and the time it takes.
+class StatisticsTimer
 {
-    if(!m_d || (m_d->type != cJSON_String)) {
-        return defaultValue;
+  public:
+    StatisticsTimer(StatisticId count, StatisticId nanoseconds)
+        : m_count(count), m_nanoseconds(nanoseconds), m_enabled(StatisticsEnabled())
+    {
+        if (m_enabled) {
+            m_start = std::chrono::steady_clock::now();
+        }
     }
-    return wxString(m_d->valuestring, conv);
-}
-
-wxArrayString wxSimpleJSON::GetValueArrayString(const wxMBConv &conv) const
-{
-    if(!m_d || (m_d->type != cJSON_Array)) {
-        return wxArrayString();
+    StatisticsTimer(const StatisticsTimer&) = delete;
+    StatisticsTimer& operator=(const StatisticsTimer&) = delete;
+    ~StatisticsTimer()
+    {
+        if (m_enabled) {
+            CountStatistic(m_count);
+            CountStatistic(m_nanoseconds, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - m_start).count());
+        }
     }
 
-    wxArrayString arr;
-    wxSimpleJSON::Ptr_t parr = Create(m_d);
-    for(size_t i = 0; i < parr->ArraySize(); ++i) {
-        arr.Add(parr->Item(i)->GetValueString(wxEmptyString, conv));
-    }
-    return arr;
-}
+    // Leaves the operation uncounted (e.g., when it is handed over to another that counts itself).
+    void Cancel() { m_enabled = false; }
 
-std::vector<wxString> wxSimpleJSON::GetValueStringVector(const wxMBConv& conv) const
+  private:
+    StatisticId m_count;
+    StatisticId m_nanoseconds;
+    bool m_enabled{ false };
+    std::chrono::steady_clock::time_point m_start;
+};
+
+// Converts a wxString to multibyte text (counting the conversion).
+static wxScopedCharBuffer ToMultiByte(const wxString &text, const wxMBConv &conv)
 {
-    if (!m_d || (m_d->type != cJSON_Array)) {
-        return std::vector<wxString>();
+    wxScopedCharBuffer buffer = text.mb_str(conv);
+    if (StatisticsEnabled()) {
+        CountStatistic(Transcodes);
+        CountStatistic(TranscodedBytes, buffer.length());
     }
+    return buffer;
+}
 
-    std::vector<wxString> arr;
-    wxSimpleJSON::Ptr_t parr = Create(m_d);
-    for (size_t i = 0; i < parr->ArraySize(); ++i) {
-        arr.emplace_back(parr->Item(i)->GetValueString(wxEmptyString, conv));
+static void InstallArenaHooks();
+
+void wxSimpleJSON::EnableStatistics(bool enable)
+{
+    // allocations are counted by the hooks
+    if (enable) {
+        InstallArenaHooks();
     }
-    return arr;
+    s_statisticsEnabled.store(enable, std::memory_order_relaxed);
 }
 
-std::vector<wxSimpleJSON::Ptr_t> wxSimpleJSON::GetValueArrayObject() const
+bool wxSimpleJSON::IsStatisticsEnabled() { return StatisticsEnabled(); }
+
+// Adds up every thread's counters (the registry must be locked).
+static void TotalStatistics(const StatisticsRegistry &registry, uint64_t (&totals)[StatisticCount])
 {
-    if(!m_d || (m_d->type != cJSON_Array)) {
-        return std::vector<wxSimpleJSON::Ptr_t>();
+    for (size_t i = 0; i < StatisticCount; ++i) {
+        totals[i] = registry.m_finished[i];
+        for (const ThreadStatistics *thread : registry.m_threads) {
+            totals[i] += thread->m_counters[i].load(std::memory_order_relaxed);
+        }
     }
+}
 
-    std::vector<wxSimpleJSON::Ptr_t> arr;
-    wxSimpleJSON::Ptr_t parr = Create(m_d);
-    for(size_t i = 0; i < parr->ArraySize(); ++i) {
-        arr.push_back(parr->Item(i));
+wxSimpleJSON::Statistics wxSimpleJSON::GetStatistics()
+{
+    StatisticsRegistry &registry = GetStatisticsRegistry();
+    uint64_t totals[StatisticCount]{ 0 };
+    {
+        std::lock_guard<std::mutex> lock(registry.m_mutex);
+        TotalStatistics(registry, totals);
+        for (size_t i = 0; i < StatisticCount; ++i) {
+            totals[i] -= std::min(totals[i], registry.m_baseline[i]);
+        }
     }
-    return arr;
+    Statistics statistics;
+    statistics.nodesCreated = totals[NodesCreated];
+    statistics.handlesCreated = totals[HandlesCreated];
+    statistics.parses = totals[Parses];
+    statistics.bytesParsed = totals[BytesParsed];
+    statistics.parseNanoseconds = totals[ParseNanoseconds];
+    statistics.prints = totals[Prints];
+    statistics.bytesPrinted = totals[BytesPrinted];
+    statistics.printNanoseconds = totals[PrintNanoseconds];
+    statistics.keyScanSteps = totals[KeyScanSteps];
+    statistics.transcodes = totals[Transcodes];
+    statistics.transcodedBytes = totals[TranscodedBytes];
+    statistics.allocations = totals[Allocations];
+    statistics.allocatedBytes = totals[AllocatedBytes];
+    statistics.frees = totals[Frees];
+    return statistics;
 }
 
-double wxSimpleJSON::GetValueNumber(double defaultValue) const
+void wxSimpleJSON::ResetStatistics()
 {
-    if(!m_d || (m_d->type != cJSON_Number)) {
-        return defaultValue;
-    }
-    return m_d->valuedouble;
+    StatisticsRegistry &registry = GetStatisticsRegistry();
+    std::lock_guard<std::mutex> lock(registry.m_mutex);
+    TotalStatistics(registry, registry.m_baseline);
 }
 
-std::vector<double> wxSimpleJSON::GetValueArrayNumber(double defaultValue) const
+// The printed text of a document's arrays and objects (see EnablePrintCache()),
+// kept so that the ones that haven't changed can be copied instead of being
+// serialized again.
+class JSONPrintCache
 {
-    if (!m_d || (m_d->type != cJSON_Array)) {
-        return std::vector<double>();
+  public:
+    // A node's text, with holes where the text of its array and object children
+    // goes (so that every part of the document's text is only kept once).
+    struct Fragment
+    {
+        std::string m_text;
+        // the offsets in m_text where the children's text goes
+        std::vector<std::pair<size_t, const cJSON *>> m_children;
+        // the indentation level the text was (pretty) printed at
+        size_t m_depth{ 0 };
+        bool m_valid{ false };
+    };
+
+    struct Entry
+    {
+        // the array or object containing the node (if it was printed through it)
+        const cJSON *m_parent{ nullptr };
+        // the compact and pretty-printed text
+        Fragment m_fragments[2];
+    };
+
+    Entry &GetEntry(const cJSON *node) { return m_entries[node]; }
+
+    // Discards the text of a changed node and of everything containing it.
+    void Invalidate(const cJSON *node)
+    {
+        while (node != nullptr) {
+            const auto entry = m_entries.find(node);
+            // a node that was never printed was added since its parent was printed
+            if (entry == m_entries.end()) {
+                return;
+            }
+            for (auto &fragment : entry->second.m_fragments) {
+                fragment.m_valid = false;
+            }
+            node = entry->second.m_parent;
+        }
     }
 
-    std::vector<double> arr;
-    wxSimpleJSON::Ptr_t parr = Create(m_d);
-    for (size_t i = 0; i < parr->ArraySize(); ++i) {
-        arr.emplace_back(parr->Item(i)->GetValueNumber(defaultValue));
+    // Forgets a node that is being deleted, along with its descendants
+    // (another node could be allocated at the same address later).
+    void Remove(const cJSON *node)
+    {
+        if (m_entries.empty() ||
+            (NodeType(node) != cJSON_Array && NodeType(node) != cJSON_Object)) {
+            return;
+        }
+        m_entries.erase(node);
+        for (const cJSON *child = node->child; child != nullptr; child = child->next) {
+            Remove(child);
+        }
     }
-    return arr;
-}
 
-wxSimpleJSON::Ptr_t wxSimpleJSON::GetProperty(const wxString &name) const
+    void Clear() { m_entries.clear(); }
+
+  private:
+    std::unordered_map<const cJSON *, Entry> m_entries;
+};
+
+struct wxSimpleJSON::PrintCache : public JSONPrintCache
 {
-    if(!m_d || (m_d->type != cJSON_Object)) {
-        return Create(nullptr);
-    }
-    return Create(cJSON_GetObjectItem(m_d, name.mb_str(wxConvUTF8).data()));
-}
+    // false once ClearPrintCache() is called through any handle
+    bool m_enabled{ true };
+};
 
-wxSimpleJSON &wxSimpleJSON::ArrayAdd(bool value)
+// Serializes a cJSON tree through a fixed-size buffer, producing the same
+// text as cJSON_Print()/cJSON_PrintUnformatted().
+// With a cache, the text of unchanged arrays and objects is copied from it,
+// and the rest is printed into it.
+class JSONWriter
 {
-    if(!m_d || (m_d->type != cJSON_Array)) {
-        return *this;
+  public:
+    JSONWriter(const wxSimpleJSON::WriteCallback &sink, bool pretty,
+               JSONPrintCache *cache = nullptr)
+        : m_sink(sink), m_pretty(pretty)
+        , m_decimalPoint(*localeconv()->decimal_point)
+        , m_cache(cache)
+    {
+    }
+
+    bool Write(const cJSON *item)
+    {
+        const StatisticsTimer timer(Prints, PrintNanoseconds);
+        return (item != nullptr && WriteValue(item) && Flush());
     }
-    if(value) {
-        cJSON_AddItemToArray(m_d, cJSON_CreateTrue());
+
+  private:
+    bool Flush()
+    {
+        if (m_used > 0 && !m_failed) {
+            CountStatistic(BytesPrinted, m_used);
+            m_failed = !m_sink(m_buffer, m_used);
+        }
+        m_used = 0;
+        return !m_failed;
     }
-    else
+
+    void Put(char c)
     {
-        cJSON_AddItemToArray(m_d, cJSON_CreateFalse());
+        if (m_capture != nullptr) {
+            m_capture->m_text.push_back(c);
+        }
+        if (m_used == sizeof(m_buffer)) {
+            Flush();
+        }
+        m_buffer[m_used++] = c;
     }
-    return *this;
-}
 
-wxSimpleJSON &wxSimpleJSON::Add(const wxString &name, bool value)
-{
-    DeleteProperty(name);
+    void Put(const char *text, size_t length)
+    {
+        if (m_capture != nullptr) {
+            m_capture->m_text.append(text, length);
+        }
+        while (length > 0) {
+            if (m_used == sizeof(m_buffer)) {
+                Flush();
+            }
+            const size_t count = std::min(length, sizeof(m_buffer) - m_used);
+            memcpy(m_buffer + m_used, text, count);
+            m_used += count;
+            text += count;
+            length -= count;
+        }
+    }
 
-    if(!m_d || (m_d->type != cJSON_Object)) {
-        return *this;
+    void Indent()
+    {
+        for (size_t i = 0; i < m_depth; ++i) {
+            Put('\t');
+        }
     }
-    cJSON_AddBoolToObject(m_d, name.mb_str(wxConvUTF8).data(), value);
-    return *this;
-}
 
-bool wxSimpleJSON::GetValueBool(bool defaultValue) const
-{
-    if(!m_d || (m_d->type != cJSON_True && m_d->type != cJSON_False)) {
-        return defaultValue;
+    bool WriteValue(const cJSON *item)
+    {
+        // a lazy node is parsed once, then is the same as any other
+        Materialize(const_cast<cJSON *>(item));
+        switch (NodeType(item)) {
+        case cJSON_NULL:
+            Put("null", 4);
+            break;
+        case cJSON_False:
+            Put("false", 5);
+            break;
+        case cJSON_True:
+            Put("true", 4);
+            break;
+        case cJSON_Number:
+            WriteNumber(item);
+            break;
+        case cJSON_Raw:
+            if (item->valuestring == nullptr) {
+                return false;
+            }
+            Put(item->valuestring, strlen(item->valuestring));
+            break;
+        case cJSON_String:
+            WriteString(item->valuestring);
+            break;
+        case cJSON_Array:
+            return (m_cache != nullptr) ? WriteCached(item) : WriteArray(item);
+        case cJSON_Object:
+            return (m_cache != nullptr) ? WriteCached(item) : WriteObject(item);
+        default:
+            return false;
+        }
+        return !m_failed;
     }
-    // at this point, type can only be cJSON_True or cJSON_False
-    return m_d->type == cJSON_True;
-}
 
-std::vector<bool> wxSimpleJSON::GetValueArrayBool(bool defaultValue) const
-{
-    if (!m_d || (m_d->type != cJSON_Array)) {
-        return std::vector<bool>();
+    // Writes an array or object through the cache: if it hasn't changed since
+    // it was last printed (at the same indentation), its text is copied from
+    // the cache, otherwise it is printed and its text is cached.
+    bool WriteCached(const cJSON *item)
+    {
+        auto &entry = m_cache->GetEntry(item);
+        if (m_parent != nullptr) {
+            entry.m_parent = m_parent;
+        }
+        // leave a hole in the text of the parent being printed
+        if (m_capture != nullptr) {
+            m_capture->m_children.emplace_back(m_capture->m_text.length(), item);
+        }
+        auto &fragment = entry.m_fragments[m_pretty ? 1 : 0];
+        JSONPrintCache::Fragment *const parentCapture = m_capture;
+        const cJSON *const parent = m_parent;
+        m_parent = item;
+        bool written{ true };
+        if (fragment.m_valid && (!m_pretty || fragment.m_depth == m_depth)) {
+            m_capture = nullptr;
+            size_t position{ 0 };
+            ++m_depth;
+            for (const auto &child : fragment.m_children) {
+                Put(fragment.m_text.data() + position, child.first - position);
+                position = child.first;
+                if (!WriteCached(child.second)) {
+                    written = false;
+                    break;
+                }
+            }
+            --m_depth;
+            if (written) {
+                Put(fragment.m_text.data() + position, fragment.m_text.length() - position);
+                written = !m_failed;
+            }
+        }
+        else {
+            fragment.m_text.clear();
+            fragment.m_children.clear();
+            fragment.m_depth = m_depth;
+            m_capture = &fragment;
+            written = (NodeType(item) == cJSON_Array) ? WriteArray(item) : WriteObject(item);
+            fragment.m_valid = written;
+        }
+        m_capture = parentCapture;
+        m_parent = parent;
+        return written;
     }
 
-    std::vector<bool> arr;
-    wxSimpleJSON::Ptr_t parr = Create(m_d);
-    for (size_t i = 0; i < parr->ArraySize(); ++i) {
-        arr.push_back(parr->Item(i)->GetValueBool(defaultValue));
+    void WriteNumber(const cJSON *item)
+    {
+        const double d = item->valuedouble;
+        char number[32]{ 0 };
+        int length{ 0 };
+        if (std::isnan(d) || std::isinf(d)) {
+            Put("null", 4);
+            return;
+        }
+        else if (d == static_cast<double>(item->valueint)) {
+            length = snprintf(number, sizeof(number), "%d", item->valueint);
+        }
+        else {
+            // try 15 decimal places of precision to avoid nonsignificant
+            // nonzero digits, and fall back to 17 if that doesn't round-trip
+            length = snprintf(number, sizeof(number), "%1.15g", d);
+            const double test = strtod(number, nullptr);
+            const double maxVal = std::max(std::fabs(test), std::fabs(d));
+            if (!(std::fabs(test - d) <= maxVal * DBL_EPSILON)) {
+                length = snprintf(number, sizeof(number), "%1.17g", d);
+            }
+        }
+        for (int i = 0; i < length; ++i) {
+            Put(number[i] == m_decimalPoint ? '.' : number[i]);
+        }
     }
-    return arr;
-}
 
-wxSimpleJSON::Ptr_t wxSimpleJSON::Create(const wxString &buffer, bool isRoot, const wxMBConv &conv)
-{
-    const char *parseEnd{ nullptr };
-    const auto scopedBuffer = buffer.mb_str(conv);
-    cJSON *p = cJSON_ParseWithOpts(scopedBuffer.data(), &parseEnd, true);
-    auto parsedNode = Create(p, isRoot);
-    if (p == nullptr) {
-        const auto lineCount = std::count(scopedBuffer.data(), parseEnd, '\n');
-        // get the full line where the error occurred
-        auto startOfErrorLine = parseEnd;
-        while (startOfErrorLine > scopedBuffer.data() && *startOfErrorLine != '\n') {
-            --startOfErrorLine;
-            if (*startOfErrorLine == '\n') {
-                ++startOfErrorLine;
-                break;
+    void WriteString(const char *text)
+    {
+        static const char hexDigits[] = "0123456789abcdef";
+        Put('\"');
+        if (text != nullptr) {
+            const char *run = text;
+            for (; *text != 0; ++text) {
+                const auto c = static_cast<unsigned char>(*text);
+                if (c >= 32 && c != '\"' && c != '\\') {
+                    continue;
+                }
+                Put(run, text - run);
+                run = text + 1;
+                Put('\\');
+                switch (c) {
+                case '\"': Put('\"'); break;
+                case '\\': Put('\\'); break;
+                case '\b': Put('b'); break;
+                case '\f': Put('f'); break;
+                case '\n': Put('n'); break;
+                case '\r': Put('r'); break;
+                case '\t': Put('t'); break;
+                default:
+                    Put("u00", 3);
+                    Put(hexDigits[c >> 4]);
+                    Put(hexDigits[c & 0x0F]);
                 }
             }
-        auto endOfErrorLine = parseEnd;
-        while (*endOfErrorLine != 0 && *endOfErrorLine != '\n') {
-            ++endOfErrorLine;
-            if (*endOfErrorLine == '\n') {
-                --endOfErrorLine;
-                break;
+            Put(run, text - run);
+        }
+        Put('\"');
+    }
+
+    bool WriteArray(const cJSON *item)
+    {
+        Put('[');
+        ++m_depth;
+        for (const cJSON *child = item->child; child != nullptr; child = child->next) {
+            if (!WriteValue(child)) {
+                return false;
+            }
+            if (child->next != nullptr) {
+                Put(',');
+                if (m_pretty) {
+                    Put(' ');
                 }
             }
-        // get the text where the error occurred
-        wxString errorLine(startOfErrorLine, conv, endOfErrorLine-startOfErrorLine);
-        wxString errorLineStartOfError(parseEnd, conv, endOfErrorLine-parseEnd);
-        parsedNode->SetLastError(
-            wxString::Format(_(L"JSON parsing error at line %s, column %s.\n\n"
-                                "full line:\n%s\n\n"
-                                "start of error:\n%s"),
-                wxNumberFormatter::ToString(lineCount + 1 /* human readable 1 indexed*/, 0,
-                                            wxNumberFormatter::Style::Style_WithThousandsSep),
-                wxNumberFormatter::ToString((parseEnd-startOfErrorLine) + 1 /* human readable 1 indexed*/, 0,
-                                            wxNumberFormatter::Style::Style_WithThousandsSep),
-                errorLine, errorLineStartOfError));
+        }
+        Put(']');
+        --m_depth;
+        return !m_failed;
     }
-    return parsedNode;
-}
 
-wxSimpleJSON::Ptr_t wxSimpleJSON::LoadFile(const wxFileName &filename, const wxMBConv &conv)
-{
-    if(!filename.Exists()) {
-        return Create(nullptr);
+    bool WriteObject(const cJSON *item)
+    {
+        Put('{');
+        ++m_depth;
+        if (m_pretty) {
+            Put('\n');
+        }
+        for (const cJSON *child = item->child; child != nullptr; child = child->next) {
+            if (m_pretty) {
+                Indent();
+            }
+            WriteString(child->string);
+            Put(':');
+            if (m_pretty) {
+                Put('\t');
+            }
+            if (!WriteValue(child)) {
+                return false;
+            }
+            if (child->next != nullptr) {
+                Put(',');
+            }
+            if (m_pretty) {
+                Put('\n');
+            }
+        }
+        --m_depth;
+        if (m_pretty) {
+            Indent();
+        }
+        Put('}');
+        return !m_failed;
     }
-    wxFFile fp(filename.GetFullPath(), "rb");
-    wxString content;
-    if(fp.IsOpened() && fp.ReadAll(&content, conv)) {
-        fp.Close();
-        return Create(content, true, conv);
+
+    const wxSimpleJSON::WriteCallback &m_sink;
+    bool m_pretty{ true };
+    bool m_failed{ false };
+    char m_decimalPoint{ '.' };
+    size_t m_depth{ 0 };
+    size_t m_used{ 0 };
+    char m_buffer[16 * 1024];
+    JSONPrintCache *m_cache{ nullptr };
+    // the cached text that the node being printed is also written to
+    JSONPrintCache::Fragment *m_capture{ nullptr };
+    // the array or object being printed
+    const cJSON *m_parent{ nullptr };
+};
+
+// Replaces text with what write() passes to its callback (leaving it empty if it fails).
+static bool WriteToString(std::string &text,
+                          const std::function<bool(const wxSimpleJSON::WriteCallback &)> &write)
+{
+    text.clear();
+    const bool written = write([&text](const char *data, size_t length)
+        {
+        text.append(data, length);
+        return true;
+        });
+    if (!written) {
+        text.clear();
     }
-    return Create(nullptr);
+    return written;
 }
 
-bool wxSimpleJSON::Save(const wxFileName &filename, const wxMBConv &conv)
+// The UTF-8 text of the last Print() on this thread, kept so that its memory
+// is reused by the next one. Text longer than this isn't kept.
+static thread_local std::string t_printBuffer;
+static const size_t MaxPrintBufferSize = 1024 * 1024;
+
+// Converts the text in t_printBuffer to a wxString.
+static wxString ConvertPrintBuffer(const wxMBConv &conv)
 {
-    wxFFile fp(filename.GetFullPath(), "wb");
-    if(fp.IsOpened()) {
-        fp.Write(Print(true, conv), conv);
-        fp.Close();
-        return true;
+    const wxString text(t_printBuffer.data(), conv, t_printBuffer.length());
+    if (t_printBuffer.capacity() > MaxPrintBufferSize) {
+        std::string().swap(t_printBuffer);
     }
-    return false;
+    return text;
 }
 
-bool wxSimpleJSON::DeleteProperty(const wxString &name)
+// Returns a Write() callback that writes to a stream.
+static wxSimpleJSON::WriteCallback StreamSink(wxOutputStream &stream)
 {
-    if(!m_d || (m_d->type != cJSON_Object)) {
-        return false;
+    return [&stream](const char *data, size_t length)
+        {
+        stream.Write(data, length);
+        return (stream.LastWrite() == length);
+        };
+}
+
+// Returns a Write() callback that writes to a file.
+static wxSimpleJSON::WriteCallback FileSink(FILE *fp)
+{
+    return [fp](const char *data, size_t length)
+        {
+        return (fwrite(data, 1, length, fp) == length);
+        };
+}
+
+// Appends an item to the end of an array or object's child list, optionally
+// (re)naming it. Like cJSON, the first child's prev pointer is kept pointing
+// at the last child so that this doesn't need to walk the list.
+static void AppendChild(cJSON *parent, cJSON *item, const char *name = nullptr)
+{
+    if (name != nullptr) {
+        const size_t length = strlen(name) + 1;
+        char *key = static_cast<char *>(cJSON_malloc(length));
+        memcpy(key, name, length);
+        if (!(item->type & cJSON_StringIsConst) && item->string) {
+            cJSON_free(item->string);
+        }
+        item->string = key;
+        item->type &= ~cJSON_StringIsConst;
     }
-    cJSON *p = cJSON_GetObjectItem(m_d, name.mb_str(wxConvUTF8).data());
-    if(!p) {
-        return false;
+    item->next = nullptr;
+    cJSON *head = parent->child;
+    if (head == nullptr) {
+        parent->child = item;
+        item->prev = item;
+        return;
     }
-    cJSON_DeleteItemFromObject(m_d, name.mb_str(wxConvUTF8).data());
-    return true;
+    cJSON *tail = head->prev;
+    if (tail == nullptr) {
+        // the list wasn't built by cJSON, so find the end the slow way
+        for (tail = head; tail->next != nullptr; tail = tail->next) {}
+    }
+    tail->next = item;
+    item->prev = tail;
+    head->prev = item;
 }
 
-bool wxSimpleJSON::DeleteProperty(int idx)
+// Compares property names the way cJSON_GetObjectItem() does.
+static bool KeysEqualNoCase(const char *first, const char *second)
 {
-    if(!m_d || (m_d->type != cJSON_Array)) {
-        return false;
+    for (; tolower(static_cast<unsigned char>(*first)) ==
+           tolower(static_cast<unsigned char>(*second)); ++first, ++second) {
+        if (*first == 0) {
+            return true;
+        }
     }
-    cJSON_DeleteItemFromArray(m_d, idx);
-    return true;
+    return false;
 }
 
-bool wxSimpleJSON::HasProperty(const wxString& name)
+// Returns the first property of an object called name, like
+// cJSON_GetObjectItem() and cJSON_GetObjectItemCaseSensitive().
+static cJSON *FindChild(const cJSON *object, const char *name, bool caseSensitive)
 {
-    if(!m_d || (m_d->type != cJSON_Object)) {
-        return false;
+    if (object == nullptr || name == nullptr) {
+        return nullptr;
     }
-    cJSON *p = cJSON_GetObjectItem(m_d, name.mb_str(wxConvUTF8).data());
-    if(!p) {
-        return false;
+    uint64_t steps{ 0 };
+    cJSON *child = object->child;
+    for (; child != nullptr; child = child->next) {
+        ++steps;
+        if (child->string != nullptr &&
+            (caseSensitive ? (strcmp(name, child->string) == 0) :
+                             KeysEqualNoCase(name, child->string))) {
+            break;
+        }
     }
-    return true;
+    CountStatistic(KeyScanSteps, steps);
+    return child;
 }
 
-wxSimpleJSON::JSONType wxSimpleJSON::GetType() const
+// Counts changes to an object's children in its (otherwise unused) valueint,
+// so that property indexes held by other handles can tell they are stale.
+static void MarkChildrenChanged(cJSON *object)
 {
-    return (IsOk() ? static_cast<wxSimpleJSON::JSONType>(m_d->type) : JSONType::IS_INVALID);
+    object->valueint = static_cast<int>(static_cast<unsigned>(object->valueint) + 1);
 }
 
-wxArrayString wxSimpleJSON::GetObjectKeys(const wxMBConv &conv)
+// Hash tables mapping property names to an object's children.
+// The keys point into the children's own (cJSON owned) names.
+struct wxSimpleJSON::KeyIndex
 {
-    cJSON *current_element = nullptr;
-    char *current_key = nullptr;
-    wxArrayString keys;
+    struct Key
+    {
+        const char *m_name;
+        size_t m_length;
+    };
 
-    cJSON_ArrayForEach(current_element, m_d)
+    struct Hash
     {
-        current_key = current_element->string;
-        if (current_key != nullptr)
+        size_t operator()(const Key &key) const
+        {
+            size_t hash = 2166136261u;
+            for (size_t i = 0; i < key.m_length; ++i) {
+                hash = (hash ^ static_cast<unsigned char>(key.m_name[i])) * 16777619u;
+            }
+            return hash;
+        }
+    };
+
+    struct Equal
+    {
+        bool operator()(const Key &first, const Key &second) const
+        {
+            return (first.m_length == second.m_length &&
+                    memcmp(first.m_name, second.m_name, first.m_length) == 0);
+        }
+    };
+
+    struct HashNoCase
+    {
+        size_t operator()(const Key &key) const
+        {
+            size_t hash = 2166136261u;
+            for (size_t i = 0; i < key.m_length; ++i) {
+                hash = (hash ^ static_cast<size_t>(
+                    tolower(static_cast<unsigned char>(key.m_name[i])))) * 16777619u;
+            }
+            return hash;
+        }
+    };
+
+    struct EqualNoCase
+    {
+        bool operator()(const Key &first, const Key &second) const
+        {
+            return (first.m_length == second.m_length &&
+                    KeysEqualNoCase(first.m_name, second.m_name));
+        }
+    };
+
+    explicit KeyIndex(const cJSON *object)
+    {
+        Build(object);
+    }
+
+    void Build(const cJSON *object)
+    {
+        m_exact.clear();
+        m_noCase.clear();
+        m_hasDuplicates = false;
+        for (cJSON *child = object->child; child != nullptr; child = child->next) {
+            Insert(child);
+        }
+        m_object = object;
+        m_changes = object->valueint;
+    }
+
+    // Whether the index still matches the object's children, i.e., the object
+    // hasn't been changed through another handle since the index was updated.
+    bool IsCurrent(const cJSON *object) const
+    {
+        return (m_object == object && m_changes == object->valueint);
+    }
+
+    // Updates the change count after a change made through the index's handle.
+    void Update(const cJSON *object)
+    {
+        m_changes = object->valueint;
+    }
+
+    // Indexes a child that was just appended to the object. Names that are
+    // already indexed keep pointing at their first (earlier) child.
+    void Insert(cJSON *child)
+    {
+        if (child->string == nullptr) {
+            return;
+        }
+        const Key key{ child->string, strlen(child->string) };
+        m_hasDuplicates |= !m_exact.emplace(key, child).second;
+        m_hasDuplicates |= !m_noCase.emplace(key, child).second;
+    }
+
+    // Unindexes a child that is about to be removed from the object.
+    void Remove(const cJSON *child)
+    {
+        if (child->string == nullptr) {
+            return;
+        }
+        const Key key{ child->string, strlen(child->string) };
+        Remove(m_exact, key, child, true);
+        Remove(m_noCase, key, child, false);
+    }
+
+    cJSON *Find(const char *name, bool caseSensitive) const
+    {
+        const Key key{ name, strlen(name) };
+        if (caseSensitive) {
+            const auto pos = m_exact.find(key);
+            return (pos != m_exact.cend()) ? pos->second : nullptr;
+        }
+        const auto pos = m_noCase.find(key);
+        return (pos != m_noCase.cend()) ? pos->second : nullptr;
+    }
+
+  private:
+    template<typename MapT>
+    void Remove(MapT &map, const Key &key, const cJSON *child, bool caseSensitive)
+    {
+        const auto pos = map.find(key);
+        if (pos == map.end() || pos->second != child) {
+            return;
+        }
+        map.erase(pos);
+        // if there were duplicate names, a later child may now be the first match
+        if (m_hasDuplicates) {
+            for (cJSON *next = child->next; next != nullptr; next = next->next) {
+                if (next->string != nullptr &&
+                    (caseSensitive ? (strcmp(child->string, next->string) == 0) :
+                                     KeysEqualNoCase(child->string, next->string))) {
+                    map.emplace(Key{ next->string, strlen(next->string) }, next);
+                    break;
+                }
+            }
+        }
+    }
+
+    const cJSON *m_object{ nullptr };
+    int m_changes{ 0 };
+    bool m_hasDuplicates{ false };
+    std::unordered_map<Key, cJSON *, Hash, Equal> m_exact;
+    std::unordered_map<Key, cJSON *, HashNoCase, EqualNoCase> m_noCase;
+};
+
+// Bump allocator that hands out memory from large blocks,
+// which are only freed when the arena is destroyed.
+class JSONArena
+{
+  public:
+    JSONArena() = default;
+    JSONArena(const JSONArena&) = delete;
+    JSONArena& operator=(const JSONArena&) = delete;
+    ~JSONArena()
+    {
+        for (auto &block : m_blocks) {
+            free(block.m_data);
+        }
+    }
+
+    void *Allocate(size_t size)
+    {
+        // nodes only need pointer/double alignment
+        size = (size + 7) & ~static_cast<size_t>(7);
+        if (!m_blocks.empty() &&
+            m_blocks.back().m_size - m_blocks.back().m_used >= size) {
+            Block &block = m_blocks.back();
+            void *ptr = block.m_data + block.m_used;
+            block.m_used += size;
+            return ptr;
+        }
+        if (size > m_nextBlockSize / 4) {
+            // give large strings their own block, leaving the current one to fill up
+            Block block{ static_cast<char *>(malloc(size)), size, size };
+            if (block.m_data == nullptr) {
+                return nullptr;
+            }
+            m_blocks.insert(m_blocks.empty() ? m_blocks.end() : m_blocks.end() - 1, block);
+            return block.m_data;
+        }
+        Block block{ static_cast<char *>(malloc(m_nextBlockSize)), m_nextBlockSize, size };
+        if (block.m_data == nullptr) {
+            return nullptr;
+        }
+        m_blocks.push_back(block);
+        m_nextBlockSize = std::min<size_t>(m_nextBlockSize * 2, MaxBlockSize);
+        return block.m_data;
+    }
+
+    // Frees everything allocated so far, keeping one block for reuse.
+    // If more than one block was in use, they are replaced by a single one
+    // that fits all of it, so that allocating as much again is free.
+    void Reset()
+    {
+        if (m_blocks.size() > 1) {
+            size_t used{ 0 };
+            for (auto &block : m_blocks) {
+                used += block.m_used;
+                free(block.m_data);
+            }
+            m_blocks.clear();
+            Block block{ static_cast<char *>(malloc(used)), used, 0 };
+            if (block.m_data != nullptr) {
+                m_blocks.push_back(block);
+            }
+        }
+        else if (!m_blocks.empty()) {
+            m_blocks.back().m_used = 0;
+        }
+    }
+
+    // Takes over another arena's memory (which is then empty).
+    void Merge(JSONArena &other)
+    {
+        // keep the current block last, so that allocation continues from it
+        m_blocks.insert(m_blocks.begin(), other.m_blocks.begin(), other.m_blocks.end());
+        other.m_blocks.clear();
+    }
+
+    bool Owns(const void *ptr) const
+    {
+        const char *p = static_cast<const char *>(ptr);
+        for (auto block = m_blocks.crbegin(); block != m_blocks.crend(); ++block) {
+            if (p >= block->m_data && p < block->m_data + block->m_size) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // The memory taken from the system (whether in use or not).
+    size_t GetReservedSize() const
+    {
+        size_t size{ 0 };
+        for (const auto &block : m_blocks) {
+            size += block.m_size;
+        }
+        return size;
+    }
+
+  private:
+    struct Block
+    {
+        char *m_data;
+        size_t m_size;
+        size_t m_used;
+    };
+
+    static const size_t MaxBlockSize = 16 * 1024 * 1024;
+    std::vector<Block> m_blocks;
+    size_t m_nextBlockSize{ 64 * 1024 };
+};
+
+const size_t JSONArena::MaxBlockSize;
+
+// The arena that cJSON allocations on this thread should come from (if any).
+static thread_local JSONArena *t_arena = nullptr;
+
+static void *ArenaMalloc(size_t size)
+{
+    if (StatisticsEnabled()) {
+        CountStatistic(Allocations);
+        CountStatistic(AllocatedBytes, size);
+    }
+    return (t_arena != nullptr) ? t_arena->Allocate(size) : malloc(size);
+}
+
+static void ArenaFree(void *ptr)
+{
+    // memory in an arena is released with the arena
+    if (ptr == nullptr || (t_arena != nullptr && t_arena->Owns(ptr))) {
+        return;
+    }
+    CountStatistic(Frees);
+    free(ptr);
+}
+
+// The library owns cJSON's allocation hooks: arenas and statistics rely on every
+// cJSON allocation going through ArenaMalloc() and ArenaFree(), so nothing else
+// may call cJSON_InitHooks(). They are installed when the first arena is created
+// (or statistics are enabled) rather than when the library is loaded. Both are
+// compatible with malloc() and free(), so memory that cJSON allocated before then
+// is still freed correctly.
+static void InstallArenaHooks()
+{
+    static std::once_flag installed;
+    std::call_once(installed, []()
+        {
+        cJSON_Hooks hooks{ ArenaMalloc, ArenaFree };
+        cJSON_InitHooks(&hooks);
+        });
+}
+
+// Routes cJSON allocations on this thread to a document's arena (or the
+// regular heap if the document doesn't have one) while in scope.
+class ArenaScope
+{
+  public:
+    template<typename StorageT>
+    explicit ArenaScope(const wxSharedPtr<StorageT> &storage)
+        : m_previous(t_arena)
+    {
+        t_arena = storage ? &storage->m_arena : nullptr;
+    }
+    explicit ArenaScope(JSONArena *arena)
+        : m_previous(t_arena)
+    {
+        t_arena = arena;
+    }
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+    ~ArenaScope() { t_arena = m_previous; }
+
+  private:
+    JSONArena *m_previous{ nullptr };
+};
+
+struct wxSimpleJSON::DocumentStorage
+{
+    DocumentStorage()
+    {
+        InstallArenaHooks();
+#if wxDEBUG_LEVEL
+        // nodes can only come from the arena while the hooks are still ours
+        const ArenaScope scope(&m_arena);
+        void *probe = cJSON_malloc(1);
+        wxASSERT_MSG(probe == nullptr || m_arena.Owns(probe),
+                     "cJSON_InitHooks() was called outside of wxSimpleJSON, which owns cJSON's hooks");
+#endif
+    }
+
+    JSONArena m_arena;
+    // the text of a lazy document, which its unparsed nodes point into
+    // (empty if the text is the caller's, see ParseOptions::borrowText)
+    wxCharBuffer m_text;
+};
+
+static cJSON *cJSONAllocNew()
+{
+    // through cJSON's hooks (which free it), but never from an arena
+    const ArenaScope scope(static_cast<JSONArena *>(nullptr));
+    cJSON *node = (cJSON *)cJSON_malloc(sizeof(cJSON));
+    if(node) memset(node, 0, sizeof(cJSON));
+    return node;
+}
+
+wxSimpleJSON::wxSimpleJSON()
+    : m_d(NULL)
+    , m_canDelete(false)
+{
+}
+
+wxSimpleJSON::~wxSimpleJSON() {}
+
+wxSimpleJSON::Ptr_t wxSimpleJSON::Create(wxSimpleJSON::JSONType type, bool isRoot)
+{
+    wxSimpleJSON *obj = new wxSimpleJSON();
+    obj->m_d = cJSONAllocNew();
+    obj->m_d->type = static_cast<int>(type);
+    CountStatistic(NodesCreated);
+    CountStatistic(HandlesCreated);
+    obj->m_canDelete = isRoot;
+    wxSimpleJSON::Ptr_t ptr(obj, wxSimpleJSON::Destroy);
+    return ptr;
+}
+
+wxSimpleJSON::Ptr_t wxSimpleJSON::Create(cJSON *p, bool canDelete)
+{
+    wxSimpleJSON *obj = new wxSimpleJSON();
+    CountStatistic(HandlesCreated);
+    obj->m_d = Materialize(p);
+    obj->m_canDelete = canDelete;
+    wxSimpleJSON::Ptr_t ptr(obj, wxSimpleJSON::Destroy);
+    return ptr;
+}
+
+wxSimpleJSON::Ptr_t wxSimpleJSON::CreateChild(cJSON *p) const
+{
+    wxSimpleJSON::Ptr_t child = Create(p);
+    child->m_storage = m_storage;
+    child->m_printCache = m_printCache;
+    return child;
+}
+
+cJSON *wxSimpleJSON::AdoptNode(wxSimpleJSON &obj) const
+{
+    if(!obj.m_d || obj.m_storage.get() == m_storage.get()) {
+        // changes made through obj now affect this document's text
+        obj.m_printCache = m_printCache;
+        return obj.m_d;
+    }
+    // nodes can't move into or out of an arena, so link in a copy
+    // (allocated by the caller's ArenaScope) instead
+    MaterializeTree(obj.m_d);
+    cJSON *copy = cJSON_Duplicate(obj.m_d, true);
+    if(!obj.m_canDelete) {
+        // a node without a parent (every child has a prev, as the first child's
+        // points at the last) was handed over to us; one that is part of another
+        // document stays there, and is freed along with it
+        if(!obj.m_storage && obj.m_d->prev == nullptr) {
+            cJSON_Delete(obj.m_d);
+        }
+        obj.m_d = copy;
+        obj.m_storage = m_storage;
+        obj.m_printCache = m_printCache;
+    }
+    return copy;
+}
+
+void wxSimpleJSON::ResetHandle()
+{
+    m_d = nullptr;
+    m_storage.reset();
+    m_index.reset();
+    m_printCache.reset();
+    m_lastError.clear();
+}
+
+wxSimpleJSON::FrozenNode wxSimpleJSON::Freeze() const
+{
+    if(!m_d) {
+        return FrozenNode();
+    }
+    // nothing may be left to parse once the document is shared
+    MaterializeTree(m_d);
+    wxSharedPtr<DocumentStorage> storage(new DocumentStorage);
+    const ArenaScope scope(storage);
+    cJSON *copy = cJSON_Duplicate(m_d, true);
+    if(!copy) {
+        return FrozenNode();
+    }
+    return FrozenNode(storage, View(copy));
+}
+
+void wxSimpleJSON::Destroy(wxSimpleJSON *obj)
+{
+    // nodes in an arena are freed along with it
+    if(obj->m_canDelete && obj->m_d && !obj->m_storage) {
+        cJSON_Delete(obj->m_d);
+    }
+    obj->m_d = nullptr;
+    wxDELETE(obj);
+}
+
+bool wxSimpleJSON::AddItem(const wxString &name, cJSON *item, bool replace,
+                           bool deleteOnFailure)
+{
+    if(!item) {
+        return false;
+    }
+    if(!m_d || (NodeType(m_d) != cJSON_Object)) {
+        if(deleteOnFailure) {
+            cJSON_Delete(item);
+        }
+        return false;
+    }
+    if(deleteOnFailure) {
+        // (otherwise the item is another document's, or a copy of it)
+        CountStatistic(NodesCreated);
+    }
+    const auto utf8Name = ToMultiByte(name, wxConvUTF8);
+    if(replace) {
+        RemoveProperty(utf8Name.data(), false);
+    }
+    MarkChanged();
+    KeyIndex *index = GetIndex();
+    AppendChild(m_d, item, utf8Name.data());
+    MarkChildrenChanged(m_d);
+    if(index) {
+        index->Insert(item);
+        index->Update(m_d);
+    }
+    return true;
+}
+
+wxSimpleJSON::KeyIndex *wxSimpleJSON::GetIndex() const
+{
+    KeyIndex *index = m_index.get();
+    if(index && !index->IsCurrent(m_d)) {
+        // the object was changed through another handle
+        index->Build(m_d);
+    }
+    return index;
+}
+
+cJSON *wxSimpleJSON::FindProperty(const char *name, bool caseSensitive) const
+{
+    if(!m_d || (NodeType(m_d) != cJSON_Object)) {
+        return nullptr;
+    }
+    const KeyIndex *index = GetIndex();
+    return index ? index->Find(name, caseSensitive) : FindChild(m_d, name, caseSensitive);
+}
+
+bool wxSimpleJSON::RemoveProperty(const char *name, bool caseSensitive)
+{
+    cJSON *p = FindProperty(name, caseSensitive);
+    if(!p) {
+        return false;
+    }
+    KeyIndex *index = GetIndex();
+    if(index) {
+        index->Remove(p);
+    }
+    DeleteDetached(cJSON_DetachItemViaPointer(m_d, p));
+    MarkChildrenChanged(m_d);
+    if(index) {
+        index->Update(m_d);
+    }
+    return true;
+}
+
+void wxSimpleJSON::MarkChanged()
+{
+    if(m_printCache && m_printCache->m_enabled) {
+        m_printCache->Invalidate(m_d);
+    }
+}
+
+void wxSimpleJSON::DeleteDetached(cJSON *item)
+{
+    if(!item) {
+        return;
+    }
+    if(m_printCache && m_printCache->m_enabled) {
+        m_printCache->Invalidate(m_d);
+        m_printCache->Remove(item);
+    }
+    cJSON_Delete(item);
+}
+
+void wxSimpleJSON::EnablePrintCache()
+{
+    if(!m_printCache || !m_printCache->m_enabled) {
+        m_printCache.reset(new PrintCache);
+    }
+}
+
+void wxSimpleJSON::ClearPrintCache()
+{
+    if(m_printCache) {
+        m_printCache->m_enabled = false;
+        m_printCache->Clear();
+        m_printCache.reset();
+    }
+}
+
+bool wxSimpleJSON::HasPrintCache() const
+{
+    return (m_printCache && m_printCache->m_enabled);
+}
+
+bool wxSimpleJSON::BuildIndex()
+{
+    if(!m_d || (NodeType(m_d) != cJSON_Object)) {
+        m_index.reset();
+        return false;
+    }
+    m_index.reset(new KeyIndex(m_d));
+    return true;
+}
+
+bool wxSimpleJSON::ArrayAddItem(cJSON *item, bool deleteOnFailure)
+{
+    if(!item) {
+        return false;
+    }
+    if(!m_d || (NodeType(m_d) != cJSON_Array)) {
+        if(deleteOnFailure) {
+            cJSON_Delete(item);
+        }
+        return false;
+    }
+    if(deleteOnFailure) {
+        CountStatistic(NodesCreated);
+    }
+    MarkChanged();
+    AppendChild(m_d, item);
+    return true;
+}
+
+wxSimpleJSON &wxSimpleJSON::ArrayAdd(wxSimpleJSON::Ptr_t obj)
+{
+    const ArenaScope scope(m_storage);
+    ArrayAddItem(AdoptNode(*obj), false);
+    return *this;
+}
+
+wxSimpleJSON &wxSimpleJSON::ArrayAdd(const wxString &value, const wxMBConv &conv)
+{
+    const ArenaScope scope(m_storage);
+    ArrayAddItem(cJSON_CreateString(ToMultiByte(value, conv).data()));
+    return *this;
+}
+
+wxSimpleJSON &wxSimpleJSON::ArrayAdd(double value)
+{
+    const ArenaScope scope(m_storage);
+    ArrayAddItem(cJSON_CreateNumber(value));
+    return *this;
+}
+
+wxSimpleJSON &wxSimpleJSON::Add(const wxString &name, wxSimpleJSON::Ptr_t obj)
+{
+    const ArenaScope scope(m_storage);
+    AddItem(name, AdoptNode(*obj), true, false);
+    return *this;
+}
+
+wxSimpleJSON &wxSimpleJSON::Add(const wxString &name, const wxString &value, const wxMBConv &conv)
+{
+    const ArenaScope scope(m_storage);
+    AddItem(name, cJSON_CreateString(ToMultiByte(value, conv).data()), true);
+    return *this;
+}
+
+wxSimpleJSON &wxSimpleJSON::Add(const wxString &name, double value)
+{
+    const ArenaScope scope(m_storage);
+    AddItem(name, cJSON_CreateNumber(value), true);
+    return *this;
+}
+
+wxSimpleJSON &wxSimpleJSON::AddNull(const wxString &name)
+{
+    const ArenaScope scope(m_storage);
+    AddItem(name, cJSON_CreateNull(), true);
+    return *this;
+}
+
+// wxSimpleJSON::ArrayBuilder
+
+wxSimpleJSON::ArrayBuilder::ArrayBuilder(const wxSimpleJSON &owner)
+    : m_owner(owner)
+    , m_previousArena(t_arena)
+{
+    t_arena = owner.m_storage ? &owner.m_storage->m_arena : nullptr;
+    m_array = cJSON_CreateArray();
+}
+
+wxSimpleJSON::ArrayBuilder::~ArrayBuilder()
+{
+    // an array that wasn't added anywhere
+    if(m_array) {
+        cJSON_Delete(m_array);
+    }
+    t_arena = static_cast<JSONArena *>(m_previousArena);
+}
+
+void wxSimpleJSON::ArrayBuilder::AppendItem(cJSON *item)
+{
+    if(!item) {
+        return;
+    }
+    if(!m_array) {
+        cJSON_Delete(item);
+        return;
+    }
+    CountStatistic(NodesCreated);
+    // link after the last item directly, instead of finding the tail each time
+    if(m_tail) {
+        m_tail->next = item;
+        item->prev = m_tail;
+    }
+    else {
+        m_array->child = item;
+    }
+    m_array->child->prev = item;
+    m_tail = item;
+}
+
+void wxSimpleJSON::ArrayBuilder::Append(bool value) { AppendItem(cJSON_CreateBool(value)); }
+
+void wxSimpleJSON::ArrayBuilder::Append(double value) { AppendItem(cJSON_CreateNumber(value)); }
+
+void wxSimpleJSON::ArrayBuilder::Append(const char *value) { AppendItem(cJSON_CreateString(value)); }
+
+void wxSimpleJSON::ArrayBuilder::Append(const wxString &value, const wxMBConv &conv)
+{
+    AppendItem(cJSON_CreateString(ToMultiByte(value, conv).data()));
+}
+
+cJSON *wxSimpleJSON::ArrayBuilder::Release()
+{
+    cJSON *array = m_array;
+    m_array = m_tail = nullptr;
+    return array;
+}
+
+wxSimpleJSON &wxSimpleJSON::ArrayAddBuilt(ArrayBuilder &builder)
+{
+    const ArenaScope scope(m_storage);
+    ArrayAddItem(builder.Release());
+    return *this;
+}
+
+wxSimpleJSON &wxSimpleJSON::AddBuilt(const wxString &name, ArrayBuilder &builder)
+{
+    const ArenaScope scope(m_storage);
+    AddItem(name, builder.Release(), true);
+    return *this;
+}
+
+wxSimpleJSON &wxSimpleJSON::ArrayAdd(const wxArrayString &arr, const wxMBConv &conv)
+{
+    ArrayBuilder builder(*this);
+    for(size_t i = 0; i < arr.size(); ++i) {
+        builder.Append(arr.Item(i), conv);
+    }
+    return ArrayAddBuilt(builder);
+}
+
+wxSimpleJSON &wxSimpleJSON::Add(const wxString &name, const wxArrayString &arr, const wxMBConv &conv)
+{
+    ArrayBuilder builder(*this);
+    for(size_t i = 0; i < arr.size(); ++i) {
+        builder.Append(arr.Item(i), conv);
+    }
+    return AddBuilt(name, builder);
+}
+
+wxSimpleJSON &wxSimpleJSON::ArrayAdd(const double *values, size_t count)
+{
+    return ArrayAddRange(values, values + count);
+}
+
+wxSimpleJSON &wxSimpleJSON::ArrayAdd(const std::vector<bool> &values)
+{
+    return ArrayAddRange(values.cbegin(), values.cend());
+}
+
+wxSimpleJSON &wxSimpleJSON::ArrayAdd(const std::vector<std::string> &values)
+{
+    return ArrayAddRange(values.cbegin(), values.cend());
+}
+
+wxSimpleJSON &wxSimpleJSON::Add(const wxString &name, const double *values, size_t count)
+{
+    return AddRange(name, values, values + count);
+}
+
+wxSimpleJSON &wxSimpleJSON::Add(const wxString &name, const std::vector<bool> &values)
+{
+    return AddRange(name, values.cbegin(), values.cend());
+}
+
+wxSimpleJSON &wxSimpleJSON::Add(const wxString &name, const std::vector<std::string> &values)
+{
+    return AddRange(name, values.cbegin(), values.cend());
+}
+
+wxSimpleJSON &wxSimpleJSON::AddUnique(const wxString &name, wxSimpleJSON::Ptr_t obj)
+{
+    const ArenaScope scope(m_storage);
+    AddItem(name, AdoptNode(*obj), false, false);
+    return *this;
+}
+
+wxSimpleJSON &wxSimpleJSON::AddUnique(const wxString &name, const wxString &value,
+                                      const wxMBConv &conv)
+{
+    const ArenaScope scope(m_storage);
+    AddItem(name, cJSON_CreateString(ToMultiByte(value, conv).data()), false);
+    return *this;
+}
+
+wxSimpleJSON &wxSimpleJSON::AddUnique(const wxString &name, double value)
+{
+    const ArenaScope scope(m_storage);
+    AddItem(name, cJSON_CreateNumber(value), false);
+    return *this;
+}
+
+wxSimpleJSON &wxSimpleJSON::AddUnique(const wxString &name, bool value)
+{
+    const ArenaScope scope(m_storage);
+    AddItem(name, cJSON_CreateBool(value), false);
+    return *this;
+}
+
+wxSimpleJSON &wxSimpleJSON::AddNullUnique(const wxString &name)
+{
+    const ArenaScope scope(m_storage);
+    AddItem(name, cJSON_CreateNull(), false);
+    return *this;
+}
+
+size_t wxSimpleJSON::ArraySize() const { return GetView().ArraySize(); }
+
+// The memory allocated for a node and everything in it
+// (strings that it only refers to are not counted).
+static size_t GetNodeMemoryUsage(const cJSON *node)
+{
+    size_t size = sizeof(cJSON);
+    if ((node->type & (cJSON_String | cJSON_Raw)) && node->valuestring != nullptr &&
+        !(node->type & cJSON_IsReference)) {
+        size += strlen(node->valuestring) + 1;
+    }
+    if (node->string != nullptr && !(node->type & cJSON_StringIsConst)) {
+        size += strlen(node->string) + 1;
+    }
+    if (!(node->type & cJSON_IsLazy)) {
+        for (const cJSON *child = node->child; child != nullptr; child = child->next) {
+            size += GetNodeMemoryUsage(child);
+        }
+    }
+    return size;
+}
+
+size_t wxSimpleJSON::GetMemoryUsage() const
+{
+    if (m_storage) {
+        return m_storage->m_arena.GetReservedSize() + m_storage->m_text.length();
+    }
+    return (m_d != nullptr) ? GetNodeMemoryUsage(m_d) : 0;
+}
+
+wxSimpleJSON::Ptr_t wxSimpleJSON::Item(size_t index) const
+{
+    return CreateChild(GetView().Item(index).m_d);
+}
+
+wxSimpleJSON::iterator wxSimpleJSON::begin() const
+{
+    if(!m_d || (NodeType(m_d) != cJSON_Array && NodeType(m_d) != cJSON_Object)) {
+        return end();
+    }
+    return iterator(m_d->child, *this);
+}
+
+wxSimpleJSON::iterator wxSimpleJSON::end() const { return iterator(nullptr, *this); }
+
+wxSimpleJSON::iterator::iterator(cJSON *node, const wxSimpleJSON &parent)
+{
+    m_node.m_d = Materialize(node);
+    m_node.m_storage = parent.m_storage;
+    m_node.m_printCache = parent.m_printCache;
+}
+
+wxSimpleJSON::iterator &wxSimpleJSON::iterator::operator++()
+{
+    if(m_node.m_d) {
+        m_node.m_d = Materialize(m_node.m_d->next);
+    }
+    return *this;
+}
+
+wxString wxSimpleJSON::GetValueString(const wxString &defaultValue,
+                                      const wxMBConv &conv) const
+{
+    return GetView().GetValueString(defaultValue, conv);
+}
+
+wxArrayString wxSimpleJSON::GetValueArrayString(const wxMBConv &conv) const
+{
+    return GetView().GetValueArrayString(conv);
+}
+
+std::vector<wxString> wxSimpleJSON::GetValueStringVector(const wxMBConv& conv) const
+{
+    return GetView().GetValueStringVector(conv);
+}
+
+wxSimpleJSON::UTF8View wxSimpleJSON::GetValueStringUTF8() const
+{
+    return GetView().GetValueStringUTF8();
+}
+
+std::vector<wxSimpleJSON::UTF8View> wxSimpleJSON::GetValueArrayStringUTF8() const
+{
+    return GetView().GetValueArrayStringUTF8();
+}
+
+std::vector<wxSimpleJSON::Ptr_t> wxSimpleJSON::GetValueArrayObject() const
+{
+    if(!m_d || (NodeType(m_d) != cJSON_Array)) {
+        return std::vector<wxSimpleJSON::Ptr_t>();
+    }
+
+    std::vector<wxSimpleJSON::Ptr_t> arr;
+    for(cJSON *child = m_d->child; child != nullptr; child = child->next) {
+        arr.push_back(CreateChild(child));
+    }
+    return arr;
+}
+
+double wxSimpleJSON::GetValueNumber(double defaultValue) const
+{
+    return GetView().GetValueNumber(defaultValue);
+}
+
+std::vector<double> wxSimpleJSON::GetValueArrayNumber(double defaultValue) const
+{
+    return GetView().GetValueArrayNumber(defaultValue);
+}
+
+size_t wxSimpleJSON::CopyArrayTo(double *values, size_t count,
+                                std::vector<size_t> *mismatches) const
+{
+    return GetView().CopyArrayTo(values, count, mismatches);
+}
+
+size_t wxSimpleJSON::CopyArrayTo(float *values, size_t count,
+                                std::vector<size_t> *mismatches) const
+{
+    return GetView().CopyArrayTo(values, count, mismatches);
+}
+
+size_t wxSimpleJSON::CopyArrayTo(int64_t *values, size_t count,
+                                std::vector<size_t> *mismatches) const
+{
+    return GetView().CopyArrayTo(values, count, mismatches);
+}
+
+size_t wxSimpleJSON::CopyArrayTo(std::vector<double> &values,
+                                std::vector<size_t> *mismatches) const
+{
+    return GetView().CopyArrayTo(values, mismatches);
+}
+
+size_t wxSimpleJSON::CopyArrayTo(std::vector<float> &values,
+                                std::vector<size_t> *mismatches) const
+{
+    return GetView().CopyArrayTo(values, mismatches);
+}
+
+size_t wxSimpleJSON::CopyArrayTo(std::vector<int64_t> &values,
+                                std::vector<size_t> *mismatches) const
+{
+    return GetView().CopyArrayTo(values, mismatches);
+}
+
+size_t wxSimpleJSON::CopyArrayPropertyTo(const wxString &name, double *values, size_t count,
+                                        std::vector<size_t> *mismatches,
+                                        bool caseSensitive) const
+{
+    return GetView().CopyArrayPropertyTo(name, values, count, mismatches, caseSensitive);
+}
+
+size_t wxSimpleJSON::CopyArrayPropertyTo(const wxString &name, float *values, size_t count,
+                                        std::vector<size_t> *mismatches,
+                                        bool caseSensitive) const
+{
+    return GetView().CopyArrayPropertyTo(name, values, count, mismatches, caseSensitive);
+}
+
+size_t wxSimpleJSON::CopyArrayPropertyTo(const wxString &name, int64_t *values, size_t count,
+                                        std::vector<size_t> *mismatches,
+                                        bool caseSensitive) const
+{
+    return GetView().CopyArrayPropertyTo(name, values, count, mismatches, caseSensitive);
+}
+
+size_t wxSimpleJSON::CopyArrayPropertyTo(const wxString &name, std::vector<double> &values,
+                                        std::vector<size_t> *mismatches,
+                                        bool caseSensitive) const
+{
+    return GetView().CopyArrayPropertyTo(name, values, mismatches, caseSensitive);
+}
+
+size_t wxSimpleJSON::CopyArrayPropertyTo(const wxString &name, std::vector<float> &values,
+                                        std::vector<size_t> *mismatches,
+                                        bool caseSensitive) const
+{
+    return GetView().CopyArrayPropertyTo(name, values, mismatches, caseSensitive);
+}
+
+size_t wxSimpleJSON::CopyArrayPropertyTo(const wxString &name, std::vector<int64_t> &values,
+                                        std::vector<size_t> *mismatches,
+                                        bool caseSensitive) const
+{
+    return GetView().CopyArrayPropertyTo(name, values, mismatches, caseSensitive);
+}
+
+wxSimpleJSON::Ptr_t wxSimpleJSON::GetProperty(const wxString &name, bool caseSensitive) const
+{
+    return CreateChild(FindProperty(ToMultiByte(name, wxConvUTF8).data(), caseSensitive));
+}
+
+wxSimpleJSON::Ptr_t wxSimpleJSON::At(const wxString &pointer) const
+{
+    return At(Path(pointer));
+}
+
+wxSimpleJSON::Ptr_t wxSimpleJSON::At(const char *pointer) const
+{
+    return At(Path(pointer));
+}
+
+wxSimpleJSON::Ptr_t wxSimpleJSON::At(const Path &path) const
+{
+    return CreateChild(path.Evaluate(GetView()).m_d);
+}
+
+wxSimpleJSON &wxSimpleJSON::ArrayAdd(bool value)
+{
+    const ArenaScope scope(m_storage);
+    ArrayAddItem(cJSON_CreateBool(value));
+    return *this;
+}
+
+wxSimpleJSON &wxSimpleJSON::Add(const wxString &name, bool value)
+{
+    const ArenaScope scope(m_storage);
+    AddItem(name, cJSON_CreateBool(value), true);
+    return *this;
+}
+
+bool wxSimpleJSON::GetValueBool(bool defaultValue) const
+{
+    return GetView().GetValueBool(defaultValue);
+}
+
+std::vector<bool> wxSimpleJSON::GetValueArrayBool(bool defaultValue) const
+{
+    return GetView().GetValueArrayBool(defaultValue);
+}
+
+wxSimpleJSON::Ptr_t wxSimpleJSON::Create(const wxString &buffer, bool isRoot, const wxMBConv &conv)
+{
+    const auto scopedBuffer = ToMultiByte(buffer, conv);
+    return Parse(scopedBuffer.data(), scopedBuffer.length(), isRoot, conv, ParseOptions());
+}
+
+wxSimpleJSON::Ptr_t wxSimpleJSON::CreateFromUTF8(const char *data, size_t length, bool isRoot)
+{
+    return Parse(data, length, isRoot, wxConvUTF8, ParseOptions());
+}
+
+wxSimpleJSON::Ptr_t wxSimpleJSON::Create(const wxString &buffer, const ParseOptions &options,
+                                         const wxMBConv &conv)
+{
+    const auto scopedBuffer = ToMultiByte(buffer, conv);
+    return Parse(scopedBuffer.data(), scopedBuffer.length(), true, conv, options);
+}
+
+wxSimpleJSON::Ptr_t wxSimpleJSON::CreateFromUTF8(const char *data, size_t length,
+                                                 const ParseOptions &options)
+{
+    return Parse(data, length, true, wxConvUTF8, options);
+}
+
+// Block scanning (SSE2/AVX2 where the CPU supports it, chosen at runtime).
+// Each function returns the first byte in [p, end) of its kind, or end.
+// All bytes <= 32 are whitespace to cJSON, and only '"' and '\\' matter
+// when scanning a string.
+
+static const char *ScanWhitespaceScalar(const char *p, const char *end)
+{
+    while (p < end && static_cast<unsigned char>(*p) <= 32) {
+        ++p;
+    }
+    return p;
+}
+
+static const char *ScanStringScalar(const char *p, const char *end)
+{
+    while (p < end && *p != '"' && *p != '\\') {
+        ++p;
+    }
+    return p;
+}
+
+static bool IsStructuralByte(unsigned char c)
+{
+    return (c == '"' || c == ',' || c == '[' || c == ']' || c == '{' || c == '}' || c >= 0x80);
+}
+
+static const char *ScanStructuralScalar(const char *p, const char *end)
+{
+    while (p < end && !IsStructuralByte(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SIMPLEJSON_X86_SIMD 1
+
+__attribute__((target("sse2")))
+static const char *ScanWhitespaceSSE2(const char *p, const char *end)
+{
+    const __m128i space = _mm_set1_epi8(32);
+    for (; end - p >= 16; p += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        // bytes <= 32 (unsigned) are unchanged by min(byte, 32)
+        const unsigned mask = ~_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(block, space), block)) & 0xFFFF;
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return ScanWhitespaceScalar(p, end);
+}
+
+__attribute__((target("sse2")))
+static const char *ScanStringSSE2(const char *p, const char *end)
+{
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    for (; end - p >= 16; p += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        const unsigned mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, quote),
+                                                             _mm_cmpeq_epi8(block, backslash)));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return ScanStringScalar(p, end);
+}
+
+__attribute__((target("sse2")))
+static const char *ScanStructuralSSE2(const char *p, const char *end)
+{
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i comma = _mm_set1_epi8(',');
+    // '{' and '}' are '[' and ']' with bit 5 set
+    const __m128i open = _mm_set1_epi8('[');
+    const __m128i close = _mm_set1_epi8(']');
+    const __m128i braceBit = _mm_set1_epi8(~0x20);
+    for (; end - p >= 16; p += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        const __m128i bracket = _mm_and_si128(block, braceBit);
+        const __m128i found = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, comma)),
+            _mm_or_si128(_mm_cmpeq_epi8(bracket, open), _mm_cmpeq_epi8(bracket, close)));
+        // the sign bit flags non-ASCII bytes
+        const unsigned mask = _mm_movemask_epi8(_mm_or_si128(found, block));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return ScanStructuralScalar(p, end);
+}
+
+__attribute__((target("avx2")))
+static const char *ScanWhitespaceAVX2(const char *p, const char *end)
+{
+    const __m256i space = _mm256_set1_epi8(32);
+    for (; end - p >= 32; p += 32) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        const unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(_mm256_min_epu8(block, space), block)));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return ScanWhitespaceSSE2(p, end);
+}
+
+__attribute__((target("avx2")))
+static const char *ScanStringAVX2(const char *p, const char *end)
+{
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    for (; end - p >= 32; p += 32) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, quote), _mm256_cmpeq_epi8(block, backslash))));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return ScanStringSSE2(p, end);
+}
+
+__attribute__((target("avx2")))
+static const char *ScanStructuralAVX2(const char *p, const char *end)
+{
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i open = _mm256_set1_epi8('[');
+    const __m256i close = _mm256_set1_epi8(']');
+    const __m256i braceBit = _mm256_set1_epi8(~0x20);
+    for (; end - p >= 32; p += 32) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        const __m256i bracket = _mm256_and_si256(block, braceBit);
+        const __m256i found = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, quote), _mm256_cmpeq_epi8(block, comma)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(bracket, open), _mm256_cmpeq_epi8(bracket, close)));
+        const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_or_si256(found, block)));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return ScanStructuralSSE2(p, end);
+}
+#endif
+
+struct ScanFunctions
+{
+    const char *(*m_whitespace)(const char *, const char *);
+    const char *(*m_string)(const char *, const char *);
+    const char *(*m_structural)(const char *, const char *);
+};
+
+// Picks the fastest scanner that the CPU supports. Setting SIMPLEJSON_SCANNER
+// to "sse2" or "scalar" caps it (e.g., to test every scanner on one machine).
+static const ScanFunctions &GetScanFunctions()
+{
+    static const ScanFunctions functions = []() -> ScanFunctions
+        {
+#ifdef SIMPLEJSON_X86_SIMD
+        const char *scanner = getenv("SIMPLEJSON_SCANNER");
+        const bool allowAVX2 = (scanner == nullptr || strcmp(scanner, "avx2") == 0);
+        const bool allowSSE2 = (allowAVX2 || strcmp(scanner, "sse2") == 0);
+        __builtin_cpu_init();
+        if (allowAVX2 && __builtin_cpu_supports("avx2")) {
+            return ScanFunctions{ ScanWhitespaceAVX2, ScanStringAVX2, ScanStructuralAVX2 };
+        }
+        if (allowSSE2 && __builtin_cpu_supports("sse2")) {
+            return ScanFunctions{ ScanWhitespaceSSE2, ScanStringSSE2, ScanStructuralSSE2 };
+        }
+#endif
+        return ScanFunctions{ ScanWhitespaceScalar, ScanStringScalar, ScanStructuralScalar };
+        }();
+    return functions;
+}
+
+// Parses JSON into cJSON nodes (allocated through cJSON's hooks), producing
+// the same tree as cJSON_ParseWithLengthOpts(). Whitespace and strings are
+// scanned in blocks, and most numbers are converted without strtod() (only
+// when the result is guaranteed to be the same). Anything malformed makes
+// Parse() return null; cJSON then parses the text again to report the error.
+class JSONParser
+{
+  public:
+    JSONParser(const char *data, size_t length)
+        : m_p(data), m_end(data + length), m_scan(GetScanFunctions())
+        , m_decimalPoint(*localeconv()->decimal_point)
+    {
+    }
+
+    cJSON *Parse(const char *&parseEnd)
+    {
+        // leave byte order marks (and empty text) to cJSON
+        if (m_p == m_end || static_cast<unsigned char>(*m_p) == 0xEF) {
+            return nullptr;
+        }
+        cJSON *item = NewItem();
+        if (item == nullptr) {
+            return nullptr;
+        }
+        SkipWhitespace();
+        if (!ParseValue(item, 0)) {
+            cJSON_Delete(item);
+            return nullptr;
+        }
+        parseEnd = m_p;
+        return item;
+    }
+
+    // Parses the string that [p, end) starts with (a property's name) into name,
+    // which is allocated through cJSON's hooks and unescaped like any other string.
+    // Returns where the string ends, or null if it is malformed.
+    const char *ParseName(const char *p, const char *end, char *&name)
+    {
+        m_p = p;
+        m_end = end;
+        name = nullptr;
+        if (m_p == m_end || *m_p != '"' || !ParseString(name)) {
+            cJSON_free(name);
+            name = nullptr;
+            return nullptr;
+        }
+        return m_p;
+    }
+
+    // The number of nodes created so far.
+    size_t GetNodeCount() const { return m_nodeCount; }
+
+  private:
+    cJSON *NewItem()
+    {
+        cJSON *item = static_cast<cJSON *>(cJSON_malloc(sizeof(cJSON)));
+        if (item != nullptr) {
+            memset(item, 0, sizeof(cJSON));
+            ++m_nodeCount;
+        }
+        return item;
+    }
+
+    void SkipWhitespace()
+    {
+        // whitespace between tokens is usually short (or missing),
+        // only long runs (deep indentation) are worth scanning in blocks
+        for (size_t i = 0; i < 8; ++i, ++m_p) {
+            if (m_p == m_end || static_cast<unsigned char>(*m_p) > 32) {
+                return;
+            }
+        }
+        m_p = m_scan.m_whitespace(m_p, m_end);
+    }
+
+    bool Literal(const char *literal, size_t length)
+    {
+        if (static_cast<size_t>(m_end - m_p) < length || memcmp(m_p, literal, length) != 0) {
+            return false;
+        }
+        m_p += length;
+        return true;
+    }
+
+    bool ParseValue(cJSON *item, size_t depth)
+    {
+        if (m_p == m_end) {
+            return false;
+        }
+        switch (*m_p) {
+        case '"':
+            item->type = cJSON_String;
+            return ParseString(item->valuestring);
+        case '{':
+            return ParseObject(item, depth);
+        case '[':
+            return ParseArray(item, depth);
+        case 'n':
+            item->type = cJSON_NULL;
+            return Literal("null", 4);
+        case 't':
+            item->type = cJSON_True;
+            item->valueint = 1;
+            return Literal("true", 4);
+        case 'f':
+            item->type = cJSON_False;
+            return Literal("false", 5);
+        case '-':
+        case '0': case '1': case '2': case '3': case '4':
+        case '5': case '6': case '7': case '8': case '9':
+            return ParseNumber(item);
+        default:
+            return false;
+        }
+    }
+
+    // Adds a new (empty) item to the end of a container.
+    cJSON *AppendItem(cJSON *container, cJSON *&tail)
+    {
+        cJSON *child = NewItem();
+        if (child != nullptr) {
+            if (tail == nullptr) {
+                container->child = child;
+            }
+            else {
+                tail->next = child;
+                child->prev = tail;
+            }
+            // like cJSON, the first child's prev is the last child
+            container->child->prev = child;
+            tail = child;
+        }
+        return child;
+    }
+
+    bool ParseArray(cJSON *item, size_t depth)
+    {
+        if (depth >= CJSON_NESTING_LIMIT) {
+            return false;
+        }
+        item->type = cJSON_Array;
+        ++m_p;
+        SkipWhitespace();
+        if (m_p < m_end && *m_p == ']') {
+            ++m_p;
+            return true;
+        }
+        cJSON *tail{ nullptr };
+        for (;;) {
+            cJSON *child = AppendItem(item, tail);
+            if (child == nullptr) {
+                return false;
+            }
+            SkipWhitespace();
+            if (!ParseValue(child, depth + 1)) {
+                return false;
+            }
+            SkipWhitespace();
+            if (m_p == m_end) {
+                return false;
+            }
+            if (*m_p == ']') {
+                ++m_p;
+                return true;
+            }
+            if (*m_p != ',') {
+                return false;
+            }
+            ++m_p;
+        }
+    }
+
+    bool ParseObject(cJSON *item, size_t depth)
+    {
+        if (depth >= CJSON_NESTING_LIMIT) {
+            return false;
+        }
+        item->type = cJSON_Object;
+        ++m_p;
+        SkipWhitespace();
+        if (m_p < m_end && *m_p == '}') {
+            ++m_p;
+            return true;
+        }
+        cJSON *tail{ nullptr };
+        for (;;) {
+            cJSON *child = AppendItem(item, tail);
+            if (child == nullptr) {
+                return false;
+            }
+            SkipWhitespace();
+            if (m_p == m_end || *m_p != '"' || !ParseString(child->string)) {
+                return false;
+            }
+            SkipWhitespace();
+            if (m_p == m_end || *m_p != ':') {
+                return false;
+            }
+            ++m_p;
+            SkipWhitespace();
+            if (!ParseValue(child, depth + 1)) {
+                return false;
+            }
+            SkipWhitespace();
+            if (m_p == m_end) {
+                return false;
+            }
+            if (*m_p == '}') {
+                ++m_p;
+                return true;
+            }
+            if (*m_p != ',') {
+                return false;
+            }
+            ++m_p;
+        }
+    }
+
+    static int HexValue(char c)
+    {
+        if (c >= '0' && c <= '9') {
+            return c - '0';
+        }
+        if (c >= 'a' && c <= 'f') {
+            return c - 'a' + 10;
+        }
+        if (c >= 'A' && c <= 'F') {
+            return c - 'A' + 10;
+        }
+        return -1;
+    }
+
+    static bool ParseHex4(const char *p, unsigned int &code)
+    {
+        code = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            const int digit = HexValue(p[i]);
+            if (digit < 0) {
+                return false;
+            }
+            code = (code << 4) | static_cast<unsigned int>(digit);
+        }
+        return true;
+    }
+
+    // Decodes the \u escape(s) at p (before the string's closing quote at end)
+    // like cJSON's utf16_literal_to_utf8(), returning the length of the escape
+    // sequence or 0 if it is invalid.
+    static size_t DecodeUnicodeEscape(const char *p, const char *end, char *&out)
+    {
+        unsigned int code{ 0 };
+        if (end - p < 6 || !ParseHex4(p + 2, code) || (code >= 0xDC00 && code <= 0xDFFF)) {
+            return 0;
+        }
+        size_t length{ 6 };
+        if (code >= 0xD800 && code <= 0xDBFF) {
+            const char *low = p + 6;
+            unsigned int lowCode{ 0 };
+            if (end - low < 6 || low[0] != '\\' || low[1] != 'u' || !ParseHex4(low + 2, lowCode) ||
+                lowCode < 0xDC00 || lowCode > 0xDFFF) {
+                return 0;
+            }
+            code = 0x10000 + (((code & 0x3FF) << 10) | (lowCode & 0x3FF));
+            length = 12;
+        }
+        if (code < 0x80) {
+            *out++ = static_cast<char>(code);
+        }
+        else if (code < 0x800) {
+            *out++ = static_cast<char>(0xC0 | (code >> 6));
+            *out++ = static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else if (code < 0x10000) {
+            *out++ = static_cast<char>(0xE0 | (code >> 12));
+            *out++ = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            *out++ = static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else {
+            *out++ = static_cast<char>(0xF0 | (code >> 18));
+            *out++ = static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            *out++ = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            *out++ = static_cast<char>(0x80 | (code & 0x3F));
+        }
+        return length;
+    }
+
+    // Parses the string starting at the opening quote into a new cJSON string.
+    bool ParseString(char *&value)
+    {
+        const char *start = m_p + 1;
+        const char *p = start;
+        bool escaped{ false };
+        // keys and short values are found quicker without a block scan
+        const char *shortEnd = std::min(m_end, start + 16);
+        while (p < shortEnd && *p != '"' && *p != '\\') {
+            ++p;
+        }
+        if (p == shortEnd) {
+            p = m_scan.m_string(p, m_end);
+        }
+        for (;;) {
+            if (p == m_end) {
+                return false;
+            }
+            if (*p == '"') {
+                break;
+            }
+            // skip the escaped character (which may be a quote)
+            if (m_end - p < 2) {
+                return false;
+            }
+            escaped = true;
+            p = m_scan.m_string(p + 2, m_end);
+        }
+        const char *quote = p;
+        char *out = static_cast<char *>(cJSON_malloc((quote - start) + 1));
+        if (out == nullptr) {
+            return false;
+        }
+        value = out;
+        if (!escaped) {
+            memcpy(out, start, quote - start);
+            out += quote - start;
+        }
+        else {
+            for (p = start; p < quote; ) {
+                const char *next = m_scan.m_string(p, quote);
+                memcpy(out, p, next - p);
+                out += next - p;
+                if (next == quote) {
+                    break;
+                }
+                // next is a backslash
+                p = next + 2;
+                switch (next[1]) {
+                case 'b': *out++ = '\b'; break;
+                case 'f': *out++ = '\f'; break;
+                case 'n': *out++ = '\n'; break;
+                case 'r': *out++ = '\r'; break;
+                case 't': *out++ = '\t'; break;
+                case '"':
+                case '\\':
+                case '/':
+                    *out++ = next[1];
+                    break;
+                case 'u':
+                    {
+                    const size_t length = DecodeUnicodeEscape(next, quote, out);
+                    if (length == 0) {
+                        *out = 0;
+                        return false;
+                    }
+                    p = next + length;
+                    break;
+                    }
+                default:
+                    *out = 0;
+                    return false;
+                }
+            }
+        }
+        *out = 0;
+        m_p = quote + 1;
+        return true;
+    }
+
+    static bool IsNumberByte(char c)
+    {
+        return ((c >= '0' && c <= '9') || c == '+' || c == '-' || c == 'e' || c == 'E' || c == '.');
+    }
+
+    // Reads a number in JSON's syntax (-123.45e6) as an integer mantissa and
+    // a power of ten. Returns false for anything else, or if it can't be
+    // converted exactly with a single multiplication or division.
+    bool ParseSimpleNumber(double &value, const char *&end) const
+    {
+#if FLT_EVAL_METHOD == 0
+        static const double powersOfTen[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+        const char *p = m_p;
+        const bool negative = (*p == '-');
+        if (negative) {
+            ++p;
+        }
+        uint64_t mantissa{ 0 };
+        int digits{ 0 };
+        int exponent{ 0 };
+        const char *integerStart = p;
+        for (; p < m_end && *p >= '0' && *p <= '9'; ++p) {
+            if (mantissa != 0 || *p != '0') {
+                mantissa = mantissa * 10 + (*p - '0');
+                ++digits;
+            }
+        }
+        if (p == integerStart) {
+            return false;
+        }
+        if (p < m_end && *p == '.') {
+            const char *fractionStart = ++p;
+            for (; p < m_end && *p >= '0' && *p <= '9'; ++p) {
+                if (mantissa != 0 || *p != '0') {
+                    mantissa = mantissa * 10 + (*p - '0');
+                    ++digits;
+                }
+                --exponent;
+            }
+            if (p == fractionStart) {
+                return false;
+            }
+        }
+        if (p < m_end && (*p == 'e' || *p == 'E')) {
+            ++p;
+            const bool negativeExponent = (p < m_end && *p == '-');
+            if (p < m_end && (*p == '-' || *p == '+')) {
+                ++p;
+            }
+            const char *exponentStart = p;
+            int explicitExponent{ 0 };
+            for (; p < m_end && *p >= '0' && *p <= '9'; ++p) {
+                if (explicitExponent < 10000) {
+                    explicitExponent = explicitExponent * 10 + (*p - '0');
+                }
+            }
+            if (p == exponentStart) {
+                return false;
+            }
+            exponent += negativeExponent ? -explicitExponent : explicitExponent;
+        }
+        // cJSON only looks at the first 63 characters, and strtod() may stop
+        // elsewhere if more number-like characters follow
+        if (p - m_p >= 63 || (p < m_end && IsNumberByte(*p)) || digits > 19) {
+            return false;
+        }
+        if (mantissa == 0) {
+            value = negative ? -0.0 : 0.0;
+        }
+        else if (mantissa <= (static_cast<uint64_t>(1) << 53) && exponent >= -22 && exponent <= 22) {
+            // both operands are exact, so this rounds once, like strtod()
+            value = static_cast<double>(mantissa);
+            value = (exponent < 0) ? value / powersOfTen[-exponent] : value * powersOfTen[exponent];
+            if (negative) {
+                value = -value;
+            }
+        }
+        else {
+            return false;
+        }
+        end = p;
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool ParseNumber(cJSON *item)
+    {
+        double number{ 0 };
+        const char *end{ nullptr };
+        if (!ParseSimpleNumber(number, end)) {
+            // do exactly what cJSON's parse_number() does
+            char text[64];
+            size_t i{ 0 };
+            for (; i < sizeof(text) - 1 && m_p + i < m_end && IsNumberByte(m_p[i]); ++i) {
+                text[i] = (m_p[i] == '.') ? m_decimalPoint : m_p[i];
+            }
+            text[i] = 0;
+            char *parsedEnd{ nullptr };
+            number = strtod(text, &parsedEnd);
+            if (parsedEnd == text) {
+                return false;
+            }
+            end = m_p + (parsedEnd - text);
+        }
+        item->type = cJSON_Number;
+        item->valuedouble = number;
+        if (number >= INT_MAX) {
+            item->valueint = INT_MAX;
+        }
+        else if (number <= static_cast<double>(INT_MIN)) {
+            item->valueint = INT_MIN;
+        }
+        else {
+            item->valueint = static_cast<int>(number);
+        }
+        m_p = end;
+        return true;
+    }
+
+    const char *m_p{ nullptr };
+    const char *m_end{ nullptr };
+    const ScanFunctions &m_scan;
+    const char m_decimalPoint{ '.' };
+    size_t m_nodeCount{ 0 };
+};
+
+// Skips the whitespace that follows a value. Like cJSON, the parser skips null
+// characters between tokens, but a null character also ends a document's text
+// (anything after it is ignored), so a document's trailing whitespace stops there.
+static const char *SkipTrailingWhitespace(const char *p, const char *end, bool isDocument)
+{
+    while (p < end && static_cast<unsigned char>(*p) <= 32 && (*p != 0 || !isDocument)) {
+        ++p;
+    }
+    return p;
+}
+
+// Parses a complete value from [data, data + length), where only whitespace may
+// follow the value (the buffer isn't necessarily null terminated, so this can't
+// be left to cJSON). isDocument is false for an element of a larger document,
+// whose text doesn't end at a null character. On failure, parseEnd is where
+// parsing stopped.
+static cJSON *ParseDocument(const char *data, size_t length, const char *&parseEnd,
+                            bool isDocument = true)
+{
+    parseEnd = nullptr;
+    if (data == nullptr) {
+        return nullptr;
+    }
+    JSONParser parser(data, length);
+    cJSON *p = parser.Parse(parseEnd);
+    CountStatistic(NodesCreated, parser.GetNodeCount());
+    if (p == nullptr) {
+        p = cJSON_ParseWithLengthOpts(data, length, &parseEnd, false);
+    }
+    if (p != nullptr) {
+        const char *trailing = SkipTrailingWhitespace(parseEnd, data + length, isDocument);
+        if (trailing < data + length && *trailing != 0) {
+            cJSON_Delete(p);
+            p = nullptr;
+            parseEnd = trailing;
+        }
+    }
+    return p;
+}
+
+// Lazy parsing
+
+// What an unparsed node of a lazy document refers to.
+struct LazyText
+{
+    const char *m_text;
+    size_t m_length;
+    // the document's arena, which the node's children are allocated from
+    JSONArena *m_arena;
+};
+
+// Creates an unparsed node for the array or object text at [text, text + length).
+static cJSON *CreateLazyNode(const char *text, size_t length, JSONArena *arena)
+{
+    cJSON *node = static_cast<cJSON *>(cJSON_malloc(sizeof(cJSON)));
+    LazyText *lazy = static_cast<LazyText *>(cJSON_malloc(sizeof(LazyText)));
+    if (node == nullptr || lazy == nullptr) {
+        cJSON_free(node);
+        cJSON_free(lazy);
+        return nullptr;
+    }
+    memset(node, 0, sizeof(cJSON));
+    CountStatistic(NodesCreated);
+    *lazy = LazyText{ text, length, arena };
+    // a reference, so that cJSON_Delete() leaves valuestring alone
+    node->type = cJSON_IsLazy | cJSON_IsReference;
+    node->valuestring = reinterpret_cast<char *>(lazy);
+    return node;
+}
+
+// Checks the structure of the array or object starting at p (its strings are
+// terminated and its brackets match), finding the text of each of its items.
+// after is set to the end of the array or object.
+static bool ScanContainer(const char *p, const char *end,
+                          std::vector<std::pair<const char *, const char *>> &items,
+                          const char *&after)
+{
+    items.clear();
+    const ScanFunctions &scan = GetScanFunctions();
+    // the closing brackets expected for the containers that are open
+    std::string closers(1, (*p == '{') ? '}' : ']');
+    const char *itemStart = ++p;
+    while ((p = scan.m_structural(p, end)) < end) {
+        const unsigned char c = *p;
+        if (c == '"') {
+            for (p = scan.m_string(p + 1, end); p < end && *p == '\\'; p = scan.m_string(p + 2, end)) {
+                if (end - p < 2) {
+                    return false;
+                }
+            }
+            if (p == end) {
+                return false;
+            }
+        }
+        else if (c == '[' || c == '{') {
+            if (closers.length() >= CJSON_NESTING_LIMIT) {
+                return false;
+            }
+            closers += (c == '[') ? ']' : '}';
+        }
+        else if (c == ']' || c == '}') {
+            if (c != static_cast<unsigned char>(closers.back())) {
+                return false;
+            }
+            closers.pop_back();
+            if (closers.empty()) {
+                items.emplace_back(itemStart, p);
+                after = p + 1;
+                // an empty container's only "item" is blank
+                if (items.size() == 1 &&
+                    std::all_of(itemStart, p, [](char ch) { return static_cast<unsigned char>(ch) <= 32; })) {
+                    items.clear();
+                }
+                return true;
+            }
+        }
+        else if (c == ',') {
+            if (closers.length() == 1) {
+                items.emplace_back(itemStart, p);
+                itemStart = p + 1;
+            }
+        }
+        else {
+            // only strings can contain anything but ASCII
+            return false;
+        }
+        ++p;
+    }
+    return false;
+}
+
+// Fills in an array or object node from the text of its items (from ScanContainer()):
+// nested arrays and objects become unparsed nodes, everything else is parsed.
+static bool BuildLevel(cJSON *node, bool isObject,
+                       const std::vector<std::pair<const char *, const char *>> &items,
+                       JSONArena *arena)
+{
+    const auto isSpace = [](char ch) { return static_cast<unsigned char>(ch) <= 32; };
+    JSONParser parser(nullptr, 0);
+    cJSON *tail = nullptr;
+    for (const auto &item : items) {
+        const char *p = std::find_if_not(item.first, item.second, isSpace);
+        const char *end = item.second;
+        while (end > p && isSpace(end[-1])) {
+            --end;
+        }
+        const char *parseEnd{ nullptr };
+        char *name = nullptr;
+        if (isObject) {
+            const char *nameEnd = parser.ParseName(p, end, name);
+            if (nameEnd == nullptr) {
+                return false;
+            }
+            p = std::find_if_not(nameEnd, end, isSpace);
+            if (p == end || *p != ':') {
+                cJSON_free(name);
+                return false;
+            }
+            p = std::find_if_not(p + 1, end, isSpace);
+        }
+        cJSON *child = (p == end) ? nullptr : (*p == '{' || *p == '[') ?
+            CreateLazyNode(p, end - p, arena) : ParseDocument(p, end - p, parseEnd, false);
+        if (child == nullptr) {
+            cJSON_free(name);
+            return false;
+        }
+        child->string = name;
+        if (tail != nullptr) {
+            tail->next = child;
+            child->prev = tail;
+        }
+        else {
+            node->child = child;
+        }
+        node->child->prev = child;
+        tail = child;
+    }
+    node->type = isObject ? cJSON_Object : cJSON_Array;
+    return true;
+}
+
+static void MaterializeNode(cJSON *node)
+{
+    const LazyText lazy = *reinterpret_cast<const LazyText *>(node->valuestring);
+    const ArenaScope scope(lazy.m_arena);
+    node->type = cJSON_Invalid;
+    node->valuestring = nullptr;
+    std::vector<std::pair<const char *, const char *>> items;
+    const char *after{ nullptr };
+    const char *end = lazy.m_text + lazy.m_length;
+    // the item's text must end with the container (e.g., not "[1] 2")
+    if (!ScanContainer(lazy.m_text, end, items, after) ||
+        SkipTrailingWhitespace(after, end, false) != end ||
+        !BuildLevel(node, *lazy.m_text == '{', items, lazy.m_arena)) {
+        // malformed text: the node stays invalid (its children, if any,
+        // were allocated from the arena and are released with it)
+        node->type = cJSON_Invalid;
+        node->child = nullptr;
+    }
+}
+
+// Parses every unparsed node in a tree (e.g., before cJSON copies it).
+static void MaterializeTree(cJSON *node)
+{
+    if (Materialize(node) == nullptr) {
+        return;
+    }
+    for (cJSON *child = node->child; child != nullptr; child = child->next) {
+        MaterializeTree(child);
+    }
+}
+
+// Resolves the number of threads requested in ParseOptions.
+static size_t GetThreadCount(unsigned int threads)
+{
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    return std::max(threads, 1u);
+}
+
+// Runs work(task) for each task in [0, tasks), each on its own thread
+// (the first one on the calling thread).
+static void ParallelFor(size_t tasks, const std::function<void(size_t task)> &work)
+{
+    std::vector<std::thread> pool;
+    for (size_t task = 1; task < tasks; ++task) {
+        pool.emplace_back(work, task);
+    }
+    if (tasks > 0) {
+        work(0);
+    }
+    for (auto &thread : pool) {
+        thread.join();
+    }
+}
+
+// Finds the top-level elements of an array document, as (offset, length) ranges.
+// Returns false if the text isn't an array that can safely be parsed one
+// element at a time (the serial parser then takes care of it).
+static bool ScanArrayElements(const char *data, size_t length,
+                              std::vector<std::pair<size_t, size_t>> &elements)
+{
+    elements.clear();
+    const char *p = data;
+    const char *end = data + length;
+    if (length >= 3 && memcmp(p, "\xEF\xBB\xBF", 3) == 0) {
+        p += 3;
+    }
+    while (p < end && static_cast<unsigned char>(*p) <= 32) {
+        ++p;
+    }
+    if (p == end || *p != '[') {
+        return false;
+    }
+    const ScanFunctions &scan = GetScanFunctions();
+    size_t depth{ 1 };
+    size_t elementStart = ++p - data;
+    bool closed{ false };
+    while (!closed && (p = scan.m_structural(p, end)) < end) {
+        const unsigned char c = *p;
+        if (c == '"') {
+            for (p = scan.m_string(p + 1, end); p < end && *p == '\\'; p = scan.m_string(p + 2, end)) {
+                if (end - p < 2) {
+                    return false;
+                }
+            }
+            if (p == end) {
+                return false;
+            }
+        }
+        else if (c == '[' || c == '{') {
+            // elements are parsed one level shallower than in the document
+            if (++depth >= CJSON_NESTING_LIMIT) {
+                return false;
+            }
+        }
+        else if (c == ']' || c == '}') {
+            if (--depth == 0) {
+                elements.emplace_back(elementStart, (p - data) - elementStart);
+                closed = true;
+            }
+        }
+        else if (c == ',') {
+            if (depth == 1) {
+                elements.emplace_back(elementStart, (p - data) - elementStart);
+                elementStart = (p - data) + 1;
+            }
+        }
+        else {
+            // only strings can contain anything but ASCII
+            return false;
+        }
+        ++p;
+    }
+    // only whitespace may follow the array
+    p = SkipTrailingWhitespace(p, end, true);
+    return (closed && (p == end || *p == 0));
+}
+
+// Parses an array document by splitting its elements between threads. Each
+// thread parses into its own arena (if the document has storage), which is
+// merged into the document's afterwards. Returns null if anything fails.
+template<typename StorageT>
+static cJSON *ParseArrayParallel(const char *data, size_t length, size_t threads,
+                                 const wxSharedPtr<StorageT> &storage)
+{
+    // not worth starting a thread for less than this
+    const size_t minimumBytesPerThread = 256 * 1024;
+    threads = std::min(threads, length / minimumBytesPerThread);
+    std::vector<std::pair<size_t, size_t>> elements;
+    if (threads < 2 || !ScanArrayElements(data, length, elements) || elements.size() < threads) {
+        return nullptr;
+    }
+
+    // split the elements into runs of about the same number of bytes
+    std::vector<size_t> firstElement{ 0 };
+    const size_t bytesPerThread = length / threads;
+    for (size_t i = 0; i < elements.size() && firstElement.size() < threads; ++i) {
+        if (elements[i].first >= bytesPerThread * firstElement.size()) {
+            firstElement.push_back(i);
+        }
+    }
+    firstElement.push_back(elements.size());
+    const size_t tasks = firstElement.size() - 1;
+
+    std::vector<wxSharedPtr<StorageT>> workerStorage(tasks);
+    std::vector<cJSON *> heads(tasks, nullptr);
+    std::vector<cJSON *> tails(tasks, nullptr);
+    std::atomic<bool> failed{ false };
+    ParallelFor(tasks, [&](size_t task)
+        {
+        if (storage) {
+            workerStorage[task].reset(new StorageT);
+        }
+        const ArenaScope scope(workerStorage[task]);
+        for (size_t i = firstElement[task]; i < firstElement[task + 1] && !failed; ++i) {
+            const char *parseEnd{ nullptr };
+            cJSON *item = ParseDocument(data + elements[i].first, elements[i].second, parseEnd, false);
+            if (item == nullptr) {
+                failed = true;
+                break;
+            }
+            if (heads[task] == nullptr) {
+                heads[task] = item;
+            }
+            else {
+                tails[task]->next = item;
+                item->prev = tails[task];
+            }
+            tails[task] = item;
+        }
+        });
+
+    cJSON *array = failed ? nullptr : cJSON_CreateArray();
+    if (array == nullptr) {
+        for (size_t task = 0; task < tasks; ++task) {
+            const ArenaScope scope(workerStorage[task]);
+            cJSON_Delete(heads[task]);
+        }
+        return nullptr;
+    }
+    // stitch the runs together (like cJSON, the first child's prev is the last child)
+    for (size_t task = 0; task < tasks; ++task) {
+        if (task > 0) {
+            tails[task - 1]->next = heads[task];
+            heads[task]->prev = tails[task - 1];
+        }
+        if (storage) {
+            storage->m_arena.Merge(workerStorage[task]->m_arena);
+        }
+    }
+    array->child = heads[0];
+    heads[0]->prev = tails[tasks - 1];
+    return array;
+}
+
+wxSimpleJSON::Ptr_t wxSimpleJSON::Parse(const char *data, size_t length, bool isRoot,
+                                        const wxMBConv &conv, const ParseOptions &options)
+{
+    if (options.lazy && isRoot && data != nullptr) {
+        if (options.borrowText) {
+            return ParseLazy(wxCharBuffer(), data, length, conv, options);
+        }
+        // the document keeps its own copy of the text
+        wxCharBuffer text(length);
+        memcpy(text.data(), data, length);
+        return ParseLazy(text, nullptr, 0, conv, options);
+    }
+
+    const StatisticsTimer timer(Parses, ParseNanoseconds);
+    CountStatistic(BytesParsed, length);
+    wxSharedPtr<DocumentStorage> storage;
+    if (options.useArena && isRoot) {
+        storage.reset(new DocumentStorage);
+    }
+    const ArenaScope scope(storage);
+
+    const char *parseEnd{ nullptr };
+    cJSON *p{ nullptr };
+    const size_t threads = GetThreadCount(options.threads);
+    if (threads > 1 && data != nullptr) {
+        p = ParseArrayParallel(data, length, threads, storage);
+    }
+    if (p == nullptr) {
+        p = ParseDocument(data, length, parseEnd);
+    }
+    auto parsedNode = Create(p, isRoot);
+    if (p != nullptr) {
+        parsedNode->m_storage = storage;
+    }
+    else if (data != nullptr) {
+        parsedNode->SetLastError(FormatParseError(data, data + length, parseEnd, conv));
+    }
+    return parsedNode;
+}
+
+wxSimpleJSON::Ptr_t wxSimpleJSON::ParseLazy(const wxCharBuffer &text, const char *data,
+                                            size_t length, const wxMBConv &conv,
+                                            const ParseOptions &options)
+{
+    StatisticsTimer timer(Parses, ParseNanoseconds);
+    wxSharedPtr<DocumentStorage> storage(new DocumentStorage);
+    storage->m_text = text;
+    if (data == nullptr) {
+        data = storage->m_text.data();
+        length = storage->m_text.length();
+    }
+    const char *end = data + length;
+
+    const char *p = data;
+    if (length >= 3 && memcmp(p, "\xEF\xBB\xBF", 3) == 0) {
+        p += 3;
+    }
+    while (p < end && static_cast<unsigned char>(*p) <= 32) {
+        ++p;
+    }
+    cJSON *root{ nullptr };
+    {
+        const ArenaScope scope(storage);
+        std::vector<std::pair<const char *, const char *>> items;
+        const char *after{ nullptr };
+        if (p < end && (*p == '{' || *p == '[') && ScanContainer(p, end, items, after)) {
+            // only whitespace may follow the document
+            after = SkipTrailingWhitespace(after, end, true);
+            if (after == end || *after == 0) {
+                root = cJSON_CreateArray();
+                CountStatistic(NodesCreated);
+                if (root != nullptr && !BuildLevel(root, *p == '{', items, &storage->m_arena)) {
+                    root = nullptr;
+                }
+            }
+        }
+    }
+    if (root == nullptr) {
+        // not something that can be parsed lazily (a lone value), or malformed:
+        // parse it all now, which also reports the error the same way
+        ParseOptions eager(options);
+        eager.lazy = false;
+        eager.useArena = true;
+        timer.Cancel();
+        return Parse(data, length, true, conv, eager);
+    }
+    CountStatistic(BytesParsed, length);
+    auto parsedNode = Create(root, true);
+    parsedNode->m_storage = storage;
+    return parsedNode;
+}
+
+wxSimpleJSON::Ptr_t wxSimpleJSON::LoadFile(const wxFileName &filename, const wxMBConv &conv)
+{
+    return LoadFile(filename, ParseOptions(), conv);
+}
+
+wxSimpleJSON::Ptr_t wxSimpleJSON::LoadFile(const wxFileName &filename, const ParseOptions &options,
+                                           const wxMBConv &conv)
+{
+    if(!filename.Exists()) {
+        return Create(nullptr);
+    }
+    wxFFile fp(filename.GetFullPath(), "rb");
+    if(!fp.IsOpened()) {
+        return Create(nullptr);
+    }
+    if(IsUTF8Conv(conv)) {
+        // read the raw bytes and hand them straight to the parser
+        const wxFileOffset length = fp.Length();
+        if(length >= 0) {
+            wxCharBuffer content(static_cast<size_t>(length));
+            if(fp.Read(content.data(), content.length()) == content.length()) {
+                fp.Close();
+                return options.lazy ? ParseLazy(content, nullptr, 0, conv, options) :
+                    Parse(content.data(), content.length(), true, conv, options);
+            }
+        }
+        return Create(nullptr);
+    }
+    wxString content;
+    if(fp.ReadAll(&content, conv)) {
+        fp.Close();
+        return Create(content, options, conv);
+    }
+    return Create(nullptr);
+}
+
+bool wxSimpleJSON::Save(const wxFileName &filename, const wxMBConv &conv)
+{
+    wxFFile fp(filename.GetFullPath(), "wb");
+    if(fp.IsOpened() && IsUTF8Conv(conv)) {
+        const bool written = Write(fp.fp(), true);
+        return (fp.Close() && written);
+    }
+    if(fp.IsOpened()) {
+        fp.Write(Print(true, conv), conv);
+        fp.Close();
+        return true;
+    }
+    return false;
+}
+
+bool wxSimpleJSON::DeleteProperty(const wxString &name, bool caseSensitive)
+{
+    const ArenaScope scope(m_storage);
+    return RemoveProperty(ToMultiByte(name, wxConvUTF8).data(), caseSensitive);
+}
+
+bool wxSimpleJSON::DeleteProperty(int idx)
+{
+    if(!m_d || (NodeType(m_d) != cJSON_Array)) {
+        return false;
+    }
+    const ArenaScope scope(m_storage);
+    DeleteDetached(cJSON_DetachItemFromArray(m_d, idx));
+    return true;
+}
+
+bool wxSimpleJSON::HasProperty(const wxString& name, bool caseSensitive) const
+{
+    return (FindProperty(ToMultiByte(name, wxConvUTF8).data(), caseSensitive) != nullptr);
+}
+
+wxSimpleJSON::JSONType wxSimpleJSON::GetType() const
+{
+    const cJSON *node = Materialize(m_d);
+    return (node != nullptr) ? static_cast<JSONType>(NodeType(node)) : JSONType::IS_INVALID;
+}
+
+wxArrayString wxSimpleJSON::GetObjectKeys(const wxMBConv &conv)
+{
+    return GetView().GetObjectKeys(conv);
+}
+
+std::vector<wxSimpleJSON::UTF8View> wxSimpleJSON::GetObjectKeysUTF8() const
+{
+    return GetView().GetObjectKeysUTF8();
+}
+
+wxSimpleJSON::UTF8View wxSimpleJSON::GetNameUTF8() const
+{
+    return GetView().GetNameUTF8();
+}
+
+wxString wxSimpleJSON::Print(bool pretty, const wxMBConv &conv) const
+{
+    PrintUTF8(t_printBuffer, pretty);
+    return ConvertPrintBuffer(conv);
+}
+
+std::string wxSimpleJSON::PrintUTF8(bool pretty) const
+{
+    std::string text;
+    PrintUTF8(text, pretty);
+    return text;
+}
+
+bool wxSimpleJSON::PrintUTF8(std::string &text, bool pretty) const
+{
+    return WriteToString(text, [this, pretty](const WriteCallback &sink)
+        { return Write(sink, pretty); });
+}
+
+bool wxSimpleJSON::Write(const WriteCallback &sink, bool pretty) const
+{
+    if(HasPrintCache()) {
+        return JSONWriter(sink, pretty, m_printCache.get()).Write(m_d);
+    }
+    return GetView().Write(sink, pretty);
+}
+
+bool wxSimpleJSON::Write(wxOutputStream &stream, bool pretty) const
+{
+    return Write(StreamSink(stream), pretty);
+}
+
+bool wxSimpleJSON::Write(FILE *fp, bool pretty) const
+{
+    return (fp != nullptr && Write(FileSink(fp), pretty));
+}
+
+// wxSimpleJSON::UTF8View
+
+bool wxSimpleJSON::UTF8View::EqualsNoCase(const char *text, size_t length) const
+{
+    if(m_length != length) {
+        return false;
+    }
+    for(size_t i = 0; i < length; ++i) {
+        if(tolower(static_cast<unsigned char>(m_data[i])) !=
+           tolower(static_cast<unsigned char>(text[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool wxSimpleJSON::UTF8View::operator<(const UTF8View &that) const
+{
+    const size_t length = std::min(m_length, that.m_length);
+    const int result = (length > 0) ? std::memcmp(m_data, that.m_data, length) : 0;
+    return (result != 0) ? (result < 0) : (m_length < that.m_length);
+}
+
+// wxSimpleJSON::Path
+
+wxSimpleJSON::Path::Path(const wxString &pointer)
+{
+    const auto utf8 = ToMultiByte(pointer, wxConvUTF8);
+    Compile(utf8.data(), utf8.length());
+}
+
+void wxSimpleJSON::Path::Compile(const char *pointer, size_t length)
+{
+    m_tokens.clear();
+    m_ok = true;
+    // the empty pointer refers to the whole document
+    if(length == 0) {
+        return;
+    }
+    if(pointer[0] != '/') {
+        m_ok = false;
+        return;
+    }
+
+    size_t pos = 1;
+    for(;;) {
+        Token token;
+        while(pos < length && pointer[pos] != '/') {
+            if(pointer[pos] == '~') {
+                // "~0" is '~' and "~1" is '/'; any other escape is malformed
+                if(pos + 1 >= length || (pointer[pos + 1] != '0' && pointer[pos + 1] != '1')) {
+                    m_tokens.clear();
+                    m_ok = false;
+                    return;
+                }
+                token.m_name += (pointer[pos + 1] == '0') ? '~' : '/';
+                pos += 2;
+            }
+            else {
+                token.m_name += pointer[pos++];
+            }
+        }
+
+        // array indices are "0" or a number without leading zeros;
+        // anything else (including "-", the element past the end) can only be a name
+        const std::string &name = token.m_name;
+        if(!name.empty() && name.length() <= 10 && (name[0] != '0' || name.length() == 1) &&
+           std::all_of(name.begin(), name.end(), [](char ch) { return (ch >= '0' && ch <= '9'); })) {
+            const unsigned long long index = std::strtoull(name.c_str(), nullptr, 10);
+            if(index <= INT_MAX) {
+                token.m_index = static_cast<size_t>(index);
+            }
+        }
+        m_tokens.push_back(std::move(token));
+
+        if(pos >= length) {
+            break;
+        }
+        ++pos; // the '/'
+    }
+}
+
+wxSimpleJSON::View wxSimpleJSON::Path::Evaluate(const View &root) const
+{
+    if(!m_ok) {
+        return View();
+    }
+    View node = root;
+    for(const auto &token : m_tokens) {
+        if(node.IsValueObject()) {
+            node = node.GetProperty(UTF8View(token.m_name.data(), token.m_name.length()), true);
+        }
+        else if(node.IsValueArray() && token.m_index != static_cast<size_t>(-1)) {
+            node = node.Item(token.m_index);
+        }
+        else {
+            return View();
+        }
+    }
+    return node;
+}
+
+// Bulk numeric extraction
+
+// Each ReadNumber() stores a number node's value in value, returning false
+// (and leaving value unchanged) if the node is not a number or the value doesn't fit.
+static bool ReadNumber(const cJSON *node, double &value)
+{
+    if(!node || NodeType(node) != cJSON_Number) {
+        return false;
+    }
+    value = node->valuedouble;
+    return true;
+}
+
+static bool ReadNumber(const cJSON *node, float &value)
+{
+    if(!node || NodeType(node) != cJSON_Number ||
+       (std::isfinite(node->valuedouble) && std::fabs(node->valuedouble) > FLT_MAX)) {
+        return false;
+    }
+    value = static_cast<float>(node->valuedouble);
+    return true;
+}
+
+static bool ReadNumber(const cJSON *node, int64_t &value)
+{
+    // the upper bound, 2^63, is exact as a double while INT64_MAX is not
+    if(!node || NodeType(node) != cJSON_Number ||
+       !(node->valuedouble >= -9223372036854775808.0 && node->valuedouble < 9223372036854775808.0) ||
+       std::floor(node->valuedouble) != node->valuedouble) {
+        return false;
+    }
+    value = static_cast<int64_t>(node->valuedouble);
+    return true;
+}
+
+// Reads the items of an array (or, if name isn't null, the property called name
+// of each item) into values, in a single walk of the array.
+template<typename T>
+static size_t CopyNumbers(const cJSON *array, const char *name, bool caseSensitive,
+                          T *values, size_t count, std::vector<size_t> *mismatches)
+{
+    if(mismatches) {
+        mismatches->clear();
+    }
+    if(!array || (NodeType(array) != cJSON_Array)) {
+        return 0;
+    }
+    size_t index = 0;
+    for(cJSON *item = array->child; item != nullptr && index < count;
+        item = item->next, ++index) {
+        const cJSON *node = item;
+        if(name != nullptr) {
+            node = (NodeType(Materialize(item)) == cJSON_Object) ?
+                FindChild(item, name, caseSensitive) : nullptr;
+        }
+        if(!ReadNumber(node, values[index]) && mismatches) {
+            mismatches->push_back(index);
+        }
+    }
+    return index;
+}
+
+template<typename T>
+static size_t CopyNumbers(const cJSON *array, const char *name, bool caseSensitive,
+                          std::vector<T> &values, std::vector<size_t> *mismatches)
+{
+    values.assign((array && NodeType(array) == cJSON_Array) ? cJSON_GetArraySize(array) : 0, T());
+    return CopyNumbers(array, name, caseSensitive, values.data(), values.size(), mismatches);
+}
+
+// wxSimpleJSON::View
+
+wxSimpleJSON::View::View(cJSON *node)
+    : m_d(Materialize(node)),
+      m_type((m_d != nullptr) ? static_cast<JSONType>(NodeType(m_d)) : JSONType::IS_INVALID)
+{
+}
+
+wxSimpleJSON::UTF8View wxSimpleJSON::View::GetText() const
+{
+    return (m_d != nullptr && m_d->valuestring != nullptr &&
+            (m_type == JSONType::IS_STRING || m_type == JSONType::IS_RAW)) ?
+        UTF8View(m_d->valuestring) : UTF8View();
+}
+
+size_t wxSimpleJSON::View::ArraySize() const { return cJSON_GetArraySize(m_d); }
+
+wxSimpleJSON::View wxSimpleJSON::View::Item(size_t index) const
+{
+    if(!m_d || (NodeType(m_d) != cJSON_Array)) {
+        return View();
+    }
+    return View(cJSON_GetArrayItem(m_d, index));
+}
+
+wxSimpleJSON::View::iterator wxSimpleJSON::View::begin() const
+{
+    if(!m_d || (NodeType(m_d) != cJSON_Array && NodeType(m_d) != cJSON_Object)) {
+        return end();
+    }
+    return iterator(View(m_d->child));
+}
+
+wxSimpleJSON::View::iterator wxSimpleJSON::View::end() const { return iterator(View()); }
+
+wxSimpleJSON::View::iterator &wxSimpleJSON::View::iterator::operator++()
+{
+    if(m_node.m_d) {
+        m_node = View(m_node.m_d->next);
+    }
+    return *this;
+}
+
+wxSimpleJSON::View wxSimpleJSON::View::GetProperty(const wxString &name, bool caseSensitive) const
+{
+    if(!m_d || (NodeType(m_d) != cJSON_Object)) {
+        return View();
+    }
+    return View(FindChild(m_d, ToMultiByte(name, wxConvUTF8).data(), caseSensitive));
+}
+
+wxSimpleJSON::View wxSimpleJSON::View::GetProperty(const char *name, bool caseSensitive) const
+{
+    if(!m_d || (NodeType(m_d) != cJSON_Object)) {
+        return View();
+    }
+    return View(FindChild(m_d, name, caseSensitive));
+}
+
+wxSimpleJSON::View wxSimpleJSON::View::GetProperty(const UTF8View &name, bool caseSensitive) const
+{
+    if(!m_d || (NodeType(m_d) != cJSON_Object) || name.IsNull()) {
+        return View();
+    }
+    // compares the names in place, without copying the name to terminate it
+    const char *const text = name.data();
+    const size_t length = name.length();
+    uint64_t steps{ 0 };
+    for(cJSON *child = m_d->child; child != nullptr; child = child->next) {
+        ++steps;
+        const char *key = child->string;
+        if(key == nullptr) {
+            continue;
+        }
+        size_t i = 0;
+        if(caseSensitive) {
+            while(i < length && key[i] == text[i] && key[i] != 0) {
+                ++i;
+            }
+        }
+        else {
+            while(i < length && key[i] != 0 &&
+                  tolower(static_cast<unsigned char>(key[i])) ==
+                  tolower(static_cast<unsigned char>(text[i]))) {
+                ++i;
+            }
+        }
+        if(i == length && key[i] == 0) {
+            CountStatistic(KeyScanSteps, steps);
+            return View(child);
+        }
+    }
+    CountStatistic(KeyScanSteps, steps);
+    return View();
+}
+
+bool wxSimpleJSON::View::HasProperty(const wxString &name, bool caseSensitive) const
+{
+    return GetProperty(name, caseSensitive).IsOk();
+}
+
+wxSimpleJSON::View wxSimpleJSON::View::At(const wxString &pointer) const
+{
+    return Path(pointer).Evaluate(*this);
+}
+
+wxSimpleJSON::View wxSimpleJSON::View::At(const char *pointer) const
+{
+    return Path(pointer).Evaluate(*this);
+}
+
+wxSimpleJSON::View wxSimpleJSON::View::At(const Path &path) const
+{
+    return path.Evaluate(*this);
+}
+
+wxArrayString wxSimpleJSON::View::GetObjectKeys(const wxMBConv &conv) const
+{
+    cJSON *current_element = nullptr;
+    char *current_key = nullptr;
+    wxArrayString keys;
+
+    cJSON_ArrayForEach(current_element, m_d)
+    {
+        current_key = current_element->string;
+        if (current_key != nullptr)
         {
             keys.Add(wxString(current_key, conv));
         }
     }
-    return keys;
+    return keys;
+}
+
+std::vector<wxSimpleJSON::UTF8View> wxSimpleJSON::View::GetObjectKeysUTF8() const
+{
+    if(!m_d || (NodeType(m_d) != cJSON_Object)) {
+        return std::vector<UTF8View>();
+    }
+
+    std::vector<UTF8View> keys;
+    keys.reserve(ArraySize());
+    for(const cJSON *child = m_d->child; child != nullptr; child = child->next) {
+        if(child->string != nullptr) {
+            keys.emplace_back(child->string);
+        }
+    }
+    return keys;
+}
+
+wxSimpleJSON::UTF8View wxSimpleJSON::View::GetNameUTF8() const
+{
+    return (m_d != nullptr) ? UTF8View(m_d->string) : UTF8View();
+}
+
+wxSimpleJSON::UTF8View wxSimpleJSON::View::GetValueStringUTF8() const
+{
+    if(!m_d || (NodeType(m_d) != cJSON_String)) {
+        return UTF8View();
+    }
+    return UTF8View(m_d->valuestring);
+}
+
+wxString wxSimpleJSON::View::GetValueString(const wxString &defaultValue,
+                                            const wxMBConv &conv) const
+{
+    if(!m_d || (NodeType(m_d) != cJSON_String)) {
+        return defaultValue;
+    }
+    return wxString(m_d->valuestring, conv);
+}
+
+bool wxSimpleJSON::View::GetValueBool(bool defaultValue) const
+{
+    if(!m_d || (NodeType(m_d) != cJSON_True && NodeType(m_d) != cJSON_False)) {
+        return defaultValue;
+    }
+    // at this point, type can only be cJSON_True or cJSON_False
+    return NodeType(m_d) == cJSON_True;
+}
+
+double wxSimpleJSON::View::GetValueNumber(double defaultValue) const
+{
+    if(!m_d || (NodeType(m_d) != cJSON_Number)) {
+        return defaultValue;
+    }
+    return m_d->valuedouble;
+}
+
+std::vector<bool> wxSimpleJSON::View::GetValueArrayBool(bool defaultValue) const
+{
+    if (!m_d || (NodeType(m_d) != cJSON_Array)) {
+        return std::vector<bool>();
+    }
+
+    std::vector<bool> arr;
+    arr.reserve(ArraySize());
+    for (const auto item : *this) {
+        arr.push_back(item.GetValueBool(defaultValue));
+    }
+    return arr;
+}
+
+wxArrayString wxSimpleJSON::View::GetValueArrayString(const wxMBConv &conv) const
+{
+    if(!m_d || (NodeType(m_d) != cJSON_Array)) {
+        return wxArrayString();
+    }
+
+    wxArrayString arr;
+    for(const auto item : *this) {
+        arr.Add(item.GetValueString(wxEmptyString, conv));
+    }
+    return arr;
+}
+
+std::vector<wxString> wxSimpleJSON::View::GetValueStringVector(const wxMBConv &conv) const
+{
+    if (!m_d || (NodeType(m_d) != cJSON_Array)) {
+        return std::vector<wxString>();
+    }
+
+    std::vector<wxString> arr;
+    arr.reserve(ArraySize());
+    for (const auto item : *this) {
+        arr.emplace_back(item.GetValueString(wxEmptyString, conv));
+    }
+    return arr;
+}
+
+std::vector<wxSimpleJSON::UTF8View> wxSimpleJSON::View::GetValueArrayStringUTF8() const
+{
+    if (!m_d || (NodeType(m_d) != cJSON_Array)) {
+        return std::vector<UTF8View>();
+    }
+
+    std::vector<UTF8View> arr;
+    arr.reserve(ArraySize());
+    for (const auto item : *this) {
+        arr.push_back(item.GetValueStringUTF8());
+    }
+    return arr;
+}
+
+std::vector<double> wxSimpleJSON::View::GetValueArrayNumber(double defaultValue) const
+{
+    if (!m_d || (NodeType(m_d) != cJSON_Array)) {
+        return std::vector<double>();
+    }
+
+    std::vector<double> arr;
+    arr.reserve(ArraySize());
+    for (const auto item : *this) {
+        arr.emplace_back(item.GetValueNumber(defaultValue));
+    }
+    return arr;
+}
+
+size_t wxSimpleJSON::View::CopyArrayTo(double *values, size_t count,
+                                      std::vector<size_t> *mismatches) const
+{
+    return CopyNumbers(m_d, nullptr, false, values, count, mismatches);
+}
+
+size_t wxSimpleJSON::View::CopyArrayTo(float *values, size_t count,
+                                      std::vector<size_t> *mismatches) const
+{
+    return CopyNumbers(m_d, nullptr, false, values, count, mismatches);
+}
+
+size_t wxSimpleJSON::View::CopyArrayTo(int64_t *values, size_t count,
+                                      std::vector<size_t> *mismatches) const
+{
+    return CopyNumbers(m_d, nullptr, false, values, count, mismatches);
+}
+
+size_t wxSimpleJSON::View::CopyArrayTo(std::vector<double> &values,
+                                      std::vector<size_t> *mismatches) const
+{
+    return CopyNumbers(m_d, nullptr, false, values, mismatches);
+}
+
+size_t wxSimpleJSON::View::CopyArrayTo(std::vector<float> &values,
+                                      std::vector<size_t> *mismatches) const
+{
+    return CopyNumbers(m_d, nullptr, false, values, mismatches);
+}
+
+size_t wxSimpleJSON::View::CopyArrayTo(std::vector<int64_t> &values,
+                                      std::vector<size_t> *mismatches) const
+{
+    return CopyNumbers(m_d, nullptr, false, values, mismatches);
+}
+
+size_t wxSimpleJSON::View::CopyArrayPropertyTo(const wxString &name, double *values, size_t count,
+                                              std::vector<size_t> *mismatches,
+                                              bool caseSensitive) const
+{
+    return CopyNumbers(m_d, ToMultiByte(name, wxConvUTF8).data(), caseSensitive, values, count, mismatches);
+}
+
+size_t wxSimpleJSON::View::CopyArrayPropertyTo(const wxString &name, float *values, size_t count,
+                                              std::vector<size_t> *mismatches,
+                                              bool caseSensitive) const
+{
+    return CopyNumbers(m_d, ToMultiByte(name, wxConvUTF8).data(), caseSensitive, values, count, mismatches);
+}
+
+size_t wxSimpleJSON::View::CopyArrayPropertyTo(const wxString &name, int64_t *values, size_t count,
+                                              std::vector<size_t> *mismatches,
+                                              bool caseSensitive) const
+{
+    return CopyNumbers(m_d, ToMultiByte(name, wxConvUTF8).data(), caseSensitive, values, count, mismatches);
+}
+
+size_t wxSimpleJSON::View::CopyArrayPropertyTo(const wxString &name, std::vector<double> &values,
+                                              std::vector<size_t> *mismatches,
+                                              bool caseSensitive) const
+{
+    return CopyNumbers(m_d, ToMultiByte(name, wxConvUTF8).data(), caseSensitive, values, mismatches);
+}
+
+size_t wxSimpleJSON::View::CopyArrayPropertyTo(const wxString &name, std::vector<float> &values,
+                                              std::vector<size_t> *mismatches,
+                                              bool caseSensitive) const
+{
+    return CopyNumbers(m_d, ToMultiByte(name, wxConvUTF8).data(), caseSensitive, values, mismatches);
+}
+
+size_t wxSimpleJSON::View::CopyArrayPropertyTo(const wxString &name, std::vector<int64_t> &values,
+                                              std::vector<size_t> *mismatches,
+                                              bool caseSensitive) const
+{
+    return CopyNumbers(m_d, ToMultiByte(name, wxConvUTF8).data(), caseSensitive, values, mismatches);
+}
+
+std::vector<wxSimpleJSON::View> wxSimpleJSON::View::GetValueArrayObject() const
+{
+    if (!m_d || (NodeType(m_d) != cJSON_Array)) {
+        return std::vector<View>();
+    }
+
+    std::vector<View> arr;
+    for (const auto item : *this) {
+        arr.push_back(item);
+    }
+    return arr;
+}
+
+wxString wxSimpleJSON::View::Print(bool pretty, const wxMBConv &conv) const
+{
+    PrintUTF8(t_printBuffer, pretty);
+    return ConvertPrintBuffer(conv);
+}
+
+std::string wxSimpleJSON::View::PrintUTF8(bool pretty) const
+{
+    std::string text;
+    PrintUTF8(text, pretty);
+    return text;
+}
+
+bool wxSimpleJSON::View::PrintUTF8(std::string &text, bool pretty) const
+{
+    return WriteToString(text, [this, pretty](const WriteCallback &sink)
+        { return Write(sink, pretty); });
+}
+
+bool wxSimpleJSON::View::Write(const WriteCallback &sink, bool pretty) const
+{
+    return JSONWriter(sink, pretty).Write(m_d);
+}
+
+bool wxSimpleJSON::View::Write(wxOutputStream &stream, bool pretty) const
+{
+    return Write(StreamSink(stream), pretty);
+}
+
+bool wxSimpleJSON::View::Write(FILE *fp, bool pretty) const
+{
+    if (fp == nullptr) {
+        return false;
+    }
+    return Write(FileSink(fp), pretty);
+}
+
+// CBOR encoding (see WriteBinary() and CreateFromBinary())
+
+// Collects small writes into fixed-size chunks for a write callback.
+class BufferedSink
+{
+  public:
+    explicit BufferedSink(const wxSimpleJSON::WriteCallback &sink) : m_sink(sink) {}
+
+    // Passes what is buffered to the callback, returning false if it (or an earlier call) failed.
+    bool Flush()
+    {
+        if (m_used > 0 && !m_failed) {
+            m_failed = !m_sink(m_buffer, m_used);
+        }
+        m_used = 0;
+        return !m_failed;
+    }
+
+    bool Failed() const { return m_failed; }
+
+    void Put(char c)
+    {
+        if (m_used == sizeof(m_buffer)) {
+            Flush();
+        }
+        m_buffer[m_used++] = c;
+    }
+
+    void Put(const void *data, size_t length)
+    {
+        const char *bytes = static_cast<const char *>(data);
+        while (length > 0) {
+            if (m_used == sizeof(m_buffer)) {
+                Flush();
+            }
+            const size_t count = std::min(length, sizeof(m_buffer) - m_used);
+            memcpy(m_buffer + m_used, bytes, count);
+            m_used += count;
+            bytes += count;
+            length -= count;
+        }
+    }
+
+  private:
+    const wxSimpleJSON::WriteCallback &m_sink;
+    bool m_failed{ false };
+    size_t m_used{ 0 };
+    char m_buffer[16 * 1024];
+};
+
+// The tag for embedded JSON text, which raw nodes are written with.
+static const uint64_t CBORTagEmbeddedJSON = 262;
+
+// Encodes a cJSON tree as CBOR (RFC 8949) through a fixed-size buffer.
+class CBORWriter
+{
+  public:
+    explicit CBORWriter(const wxSimpleJSON::WriteCallback &sink) : m_out(sink) {}
+
+    bool Write(const cJSON *item)
+    {
+        return (item != nullptr && WriteValue(item) && m_out.Flush());
+    }
+
+  private:
+    // CBOR's major types
+    enum MajorType
+    {
+        Unsigned = 0,
+        Negative = 1,
+        Text = 3,
+        Array = 4,
+        Map = 5,
+        Tag = 6,
+        Simple = 7
+    };
+
+    void Put(uint8_t byte) { m_out.Put(static_cast<char>(byte)); }
+
+    void Put(const char *data, size_t length) { m_out.Put(data, length); }
+
+    // Writes the big-endian bytes of the low byteCount bytes of value.
+    void PutBigEndian(uint64_t value, size_t byteCount)
+    {
+        while (byteCount > 0) {
+            --byteCount;
+            Put(static_cast<uint8_t>(value >> (byteCount * 8)));
+        }
+    }
+
+    // Writes an item's initial byte and argument, in as few bytes as possible.
+    void PutHead(MajorType type, uint64_t argument)
+    {
+        const uint8_t major = static_cast<uint8_t>(type << 5);
+        if (argument < 24) {
+            Put(static_cast<uint8_t>(major | argument));
+        }
+        else if (argument <= 0xFF) {
+            Put(static_cast<uint8_t>(major | 24));
+            PutBigEndian(argument, 1);
+        }
+        else if (argument <= 0xFFFF) {
+            Put(static_cast<uint8_t>(major | 25));
+            PutBigEndian(argument, 2);
+        }
+        else if (argument <= 0xFFFFFFFF) {
+            Put(static_cast<uint8_t>(major | 26));
+            PutBigEndian(argument, 4);
+        }
+        else {
+            Put(static_cast<uint8_t>(major | 27));
+            PutBigEndian(argument, 8);
+        }
+    }
+
+    void PutText(const char *text)
+    {
+        const size_t length = (text != nullptr) ? strlen(text) : 0;
+        PutHead(Text, length);
+        Put(text, length);
+    }
+
+    void PutNumber(double value)
+    {
+        // JSON has no NaN or infinities, so (like the text writer) write them as null
+        if (!std::isfinite(value)) {
+            Put(static_cast<uint8_t>((Simple << 5) | 22));
+            return;
+        }
+        // whole numbers (other than -0) are written as integers
+        if (value >= -9223372036854775808.0 && value < 9223372036854775808.0 &&
+            value == std::floor(value) && !(value == 0 && std::signbit(value))) {
+            const auto integer = static_cast<int64_t>(value);
+            if (integer >= 0) {
+                PutHead(Unsigned, static_cast<uint64_t>(integer));
+            }
+            else {
+                PutHead(Negative, static_cast<uint64_t>(-(integer + 1)));
+            }
+            return;
+        }
+        // others as single precision if that holds them exactly, otherwise double
+        if (std::fabs(value) <= FLT_MAX && static_cast<double>(static_cast<float>(value)) == value) {
+            const float single = static_cast<float>(value);
+            uint32_t bits{ 0 };
+            memcpy(&bits, &single, sizeof(bits));
+            Put(static_cast<uint8_t>((Simple << 5) | 26));
+            PutBigEndian(bits, 4);
+            return;
+        }
+        uint64_t bits{ 0 };
+        memcpy(&bits, &value, sizeof(bits));
+        Put(static_cast<uint8_t>((Simple << 5) | 27));
+        PutBigEndian(bits, 8);
+    }
+
+    bool WriteValue(const cJSON *item)
+    {
+        Materialize(const_cast<cJSON *>(item));
+        switch (NodeType(item)) {
+        case cJSON_NULL:
+            Put(static_cast<uint8_t>((Simple << 5) | 22));
+            break;
+        case cJSON_False:
+            Put(static_cast<uint8_t>((Simple << 5) | 20));
+            break;
+        case cJSON_True:
+            Put(static_cast<uint8_t>((Simple << 5) | 21));
+            break;
+        case cJSON_Number:
+            PutNumber(item->valuedouble);
+            break;
+        case cJSON_String:
+            PutText(item->valuestring);
+            break;
+        case cJSON_Raw:
+            if (item->valuestring == nullptr) {
+                return false;
+            }
+            PutHead(Tag, CBORTagEmbeddedJSON);
+            PutText(item->valuestring);
+            break;
+        case cJSON_Array:
+        case cJSON_Object:
+            {
+            const bool isObject = (NodeType(item) == cJSON_Object);
+            size_t count{ 0 };
+            for (const cJSON *child = item->child; child != nullptr; child = child->next) {
+                ++count;
+            }
+            PutHead(isObject ? Map : Array, count);
+            for (const cJSON *child = item->child; child != nullptr; child = child->next) {
+                if (isObject) {
+                    PutText(child->string);
+                }
+                if (!WriteValue(child)) {
+                    return false;
+                }
+            }
+            break;
+            }
+        default:
+            return false;
+        }
+        return !m_out.Failed();
+    }
+
+    BufferedSink m_out;
+};
+
+// Decodes CBOR into cJSON nodes (allocated through cJSON's hooks).
+class CBORReader
+{
+  public:
+    CBORReader(const void *data, size_t length)
+        : m_begin(static_cast<const uint8_t *>(data)), m_p(m_begin), m_end(m_begin + length)
+    {
+    }
+
+    // Returns the decoded item (which must be the whole of the data), or null.
+    cJSON *Read()
+    {
+        cJSON *item = ReadValue(0);
+        if (item != nullptr && m_p != m_end) {
+            cJSON_Delete(item);
+            item = nullptr;
+        }
+        return item;
+    }
+
+    // The offset of the byte where decoding failed.
+    size_t GetErrorOffset() const { return m_p - m_begin; }
+    // The number of nodes created so far.
+    size_t GetNodeCount() const { return m_nodeCount; }
+
+  private:
+    static const uint8_t Break = 0xFF;
+    static const uint64_t Indefinite = static_cast<uint64_t>(-1);
+
+    // Reads an item's initial byte and argument (Indefinite for an
+    // indefinite length), leaving m_p at the initial byte on failure.
+    bool ReadHead(int &major, uint64_t &argument)
+    {
+        if (m_p == m_end) {
+            return false;
+        }
+        major = *m_p >> 5;
+        const uint8_t info = *m_p & 0x1F;
+        size_t byteCount{ 0 };
+        if (info < 24) {
+            argument = info;
+        }
+        else if (info <= 27) {
+            byteCount = size_t(1) << (info - 24);
+            if (static_cast<size_t>(m_end - m_p) <= byteCount) {
+                return false;
+            }
+            argument = 0;
+            for (size_t i = 1; i <= byteCount; ++i) {
+                argument = (argument << 8) | m_p[i];
+            }
+        }
+        else if (info == 31 && major >= 2 && major != 6) {
+            argument = Indefinite;
+        }
+        else {
+            return false;
+        }
+        m_p += 1 + byteCount;
+        return true;
+    }
+
+    static cJSON *NewItem(int type)
+    {
+        cJSON *item = static_cast<cJSON *>(cJSON_malloc(sizeof(cJSON)));
+        if (item != nullptr) {
+            memset(item, 0, sizeof(cJSON));
+            item->type = type;
+        }
+        return item;
+    }
+
+    // Reads a text string (the argument of its head is given) into a new
+    // null-terminated copy. Text can't contain nulls, which cJSON can't hold.
+    char *ReadText(uint64_t length)
+    {
+        if (length != Indefinite) {
+            if (length > static_cast<uint64_t>(m_end - m_p) ||
+                memchr(m_p, 0, static_cast<size_t>(length)) != nullptr) {
+                return nullptr;
+            }
+            char *text = static_cast<char *>(cJSON_malloc(static_cast<size_t>(length) + 1));
+            if (text != nullptr) {
+                memcpy(text, m_p, static_cast<size_t>(length));
+                text[length] = 0;
+                m_p += length;
+            }
+            return text;
+        }
+        // an indefinite length string is a series of definite length text strings
+        std::string chunks;
+        while (m_p < m_end && *m_p != Break) {
+            const uint8_t *chunk = m_p;
+            int major{ 0 };
+            uint64_t chunkLength{ 0 };
+            if (!ReadHead(major, chunkLength) || major != 3 || chunkLength == Indefinite ||
+                chunkLength > static_cast<uint64_t>(m_end - m_p) ||
+                memchr(m_p, 0, static_cast<size_t>(chunkLength)) != nullptr) {
+                m_p = chunk;
+                return nullptr;
+            }
+            chunks.append(reinterpret_cast<const char *>(m_p), static_cast<size_t>(chunkLength));
+            m_p += chunkLength;
+        }
+        if (m_p == m_end) {
+            return nullptr;
+        }
+        ++m_p;
+        char *text = static_cast<char *>(cJSON_malloc(chunks.length() + 1));
+        if (text != nullptr) {
+            memcpy(text, chunks.c_str(), chunks.length() + 1);
+        }
+        return text;
+    }
+
+    // Reads the items of an array or map into container (which is deleted on failure).
+    cJSON *ReadItems(cJSON *container, uint64_t count, size_t depth)
+    {
+        const bool isObject = (NodeType(container) == cJSON_Object);
+        // a definite count can't be more than the bytes left (each item takes one at least)
+        if (count != Indefinite && count > static_cast<uint64_t>(m_end - m_p)) {
+            cJSON_Delete(container);
+            return nullptr;
+        }
+        for (uint64_t i = 0; (count == Indefinite) ? (m_p < m_end && *m_p != Break) : (i < count);
+             ++i) {
+            char *key{ nullptr };
+            if (isObject) {
+                const uint8_t *head = m_p;
+                int major{ 0 };
+                uint64_t length{ 0 };
+                if (!ReadHead(major, length) || major != 3 ||
+                    (key = ReadText(length)) == nullptr) {
+                    m_p = head;
+                    cJSON_Delete(container);
+                    return nullptr;
+                }
+            }
+            cJSON *item = ReadValue(depth + 1);
+            if (item == nullptr) {
+                if (key != nullptr) {
+                    cJSON_free(key);
+                }
+                cJSON_Delete(container);
+                return nullptr;
+            }
+            item->string = key;
+            AppendChild(container, item);
+        }
+        if (count == Indefinite) {
+            if (m_p == m_end) {
+                cJSON_Delete(container);
+                return nullptr;
+            }
+            ++m_p;
+        }
+        return container;
+    }
+
+    cJSON *ReadValue(size_t depth)
+    {
+        if (depth >= CJSON_NESTING_LIMIT) {
+            return nullptr;
+        }
+        const uint8_t *head = m_p;
+        int major{ 0 };
+        uint64_t argument{ 0 };
+        if (!ReadHead(major, argument)) {
+            return nullptr;
+        }
+        cJSON *item{ nullptr };
+        switch (major) {
+        case 0:
+            item = cJSON_CreateNumber(static_cast<double>(argument));
+            break;
+        case 1:
+            // -1 - argument, rounded once (-2^64 is exact)
+            item = cJSON_CreateNumber((argument == UINT64_MAX) ? -18446744073709551616.0 :
+                                      -static_cast<double>(argument + 1));
+            break;
+        case 3:
+            {
+            char *text = ReadText(argument);
+            if (text != nullptr) {
+                item = NewItem(cJSON_String);
+                if (item != nullptr) {
+                    item->valuestring = text;
+                }
+                else {
+                    cJSON_free(text);
+                }
+            }
+            break;
+            }
+        case 4:
+        case 5:
+            {
+            cJSON *container = NewItem((major == 4) ? cJSON_Array : cJSON_Object);
+            if (container != nullptr) {
+                item = ReadItems(container, argument, depth);
+            }
+            break;
+            }
+        case 6:
+            if (argument == CBORTagEmbeddedJSON) {
+                // raw JSON text
+                int textMajor{ 0 };
+                uint64_t length{ 0 };
+                const uint8_t *textHead = m_p;
+                char *text{ nullptr };
+                if (ReadHead(textMajor, length) && textMajor == 3 &&
+                    (text = ReadText(length)) != nullptr) {
+                    item = NewItem(cJSON_Raw);
+                    if (item != nullptr) {
+                        item->valuestring = text;
+                    }
+                    else {
+                        cJSON_free(text);
+                    }
+                }
+                else {
+                    m_p = textHead;
+                }
+            }
+            else {
+                // other tags only qualify the value, which is read as is
+                return ReadValue(depth + 1);
+            }
+            break;
+        case 7:
+            item = ReadSimple(head, argument);
+            break;
+        default:
+            // byte strings have no JSON equivalent
+            break;
+        }
+        if (item == nullptr && major != 4 && major != 5) {
+            // point at the item that couldn't be read (errors in nested items are left where they are)
+            m_p = head;
+        }
+        m_nodeCount += (item != nullptr) ? 1 : 0;
+        return item;
+    }
+
+    // Reads a simple value or float (whose head is at head).
+    cJSON *ReadSimple(const uint8_t *head, uint64_t argument)
+    {
+        const uint8_t info = *head & 0x1F;
+        switch (info) {
+        case 20:
+            return cJSON_CreateFalse();
+        case 21:
+            return cJSON_CreateTrue();
+        case 22:
+        case 23:
+            // undefined has no JSON equivalent, so it is read as null
+            return cJSON_CreateNull();
+        case 25:
+            {
+            // half precision
+            const int exponent = static_cast<int>((argument >> 10) & 0x1F);
+            const double mantissa = static_cast<double>(argument & 0x3FF);
+            double value{ 0 };
+            if (exponent == 0) {
+                value = std::ldexp(mantissa, -24);
+            }
+            else if (exponent != 31) {
+                value = std::ldexp(mantissa + 1024, exponent - 25);
+            }
+            else {
+                // NaN and infinities have no JSON equivalent
+                return nullptr;
+            }
+            return cJSON_CreateNumber((argument & 0x8000) ? -value : value);
+            }
+        case 26:
+            {
+            const uint32_t bits = static_cast<uint32_t>(argument);
+            float value{ 0 };
+            memcpy(&value, &bits, sizeof(value));
+            return std::isfinite(value) ? cJSON_CreateNumber(value) : nullptr;
+            }
+        case 27:
+            {
+            double value{ 0 };
+            memcpy(&value, &argument, sizeof(value));
+            return std::isfinite(value) ? cJSON_CreateNumber(value) : nullptr;
+            }
+        default:
+            return nullptr;
+        }
+    }
+
+    const uint8_t *m_begin{ nullptr };
+    const uint8_t *m_p{ nullptr };
+    const uint8_t *m_end{ nullptr };
+    size_t m_nodeCount{ 0 };
+};
+
+wxSimpleJSON::Ptr_t wxSimpleJSON::CreateFromBinary(const void *data, size_t length)
+{
+    return CreateFromBinary(data, length, ParseOptions());
+}
+
+wxSimpleJSON::Ptr_t wxSimpleJSON::CreateFromBinary(const void *data, size_t length,
+                                                   const ParseOptions &options)
+{
+    wxSharedPtr<DocumentStorage> storage;
+    if (options.useArena) {
+        storage.reset(new DocumentStorage);
+    }
+    const StatisticsTimer timer(Parses, ParseNanoseconds);
+    CountStatistic(BytesParsed, length);
+    const ArenaScope scope(storage);
+    CBORReader reader(data, length);
+    cJSON *p = (data != nullptr) ? reader.Read() : nullptr;
+    CountStatistic(NodesCreated, reader.GetNodeCount());
+    auto decodedNode = Create(p, true);
+    if (p != nullptr) {
+        decodedNode->m_storage = storage;
+    }
+    else if (data != nullptr) {
+        decodedNode->SetLastError(wxString::Format(_(L"CBOR decoding error at byte %s."),
+            wxNumberFormatter::ToString(static_cast<long>(reader.GetErrorOffset()), 0,
+                                        wxNumberFormatter::Style::Style_WithThousandsSep)));
+    }
+    return decodedNode;
+}
+
+wxSimpleJSON::Ptr_t wxSimpleJSON::LoadBinary(const wxFileName &filename)
+{
+    return LoadBinary(filename, ParseOptions());
+}
+
+wxSimpleJSON::Ptr_t wxSimpleJSON::LoadBinary(const wxFileName &filename,
+                                             const ParseOptions &options)
+{
+    if (!filename.Exists()) {
+        return Create(nullptr);
+    }
+    wxFFile fp(filename.GetFullPath(), "rb");
+    if (!fp.IsOpened()) {
+        return Create(nullptr);
+    }
+    const wxFileOffset length = fp.Length();
+    if (length >= 0) {
+        wxCharBuffer content(static_cast<size_t>(length));
+        if (fp.Read(content.data(), content.length()) == content.length()) {
+            fp.Close();
+            return CreateFromBinary(content.data(), content.length(), options);
+        }
+    }
+    return Create(nullptr);
+}
+
+bool wxSimpleJSON::WriteBinary(const WriteCallback &sink) const
+{
+    return GetView().WriteBinary(sink);
+}
+
+bool wxSimpleJSON::WriteBinary(std::string &data) const
+{
+    return GetView().WriteBinary(data);
+}
+
+bool wxSimpleJSON::SaveBinary(const wxFileName &filename) const
+{
+    wxFFile fp(filename.GetFullPath(), "wb");
+    if (!fp.IsOpened()) {
+        return false;
+    }
+    const bool written = WriteBinary(FileSink(fp.fp()));
+    return (fp.Close() && written);
+}
+
+bool wxSimpleJSON::View::WriteBinary(const WriteCallback &sink) const
+{
+    return CBORWriter(sink).Write(m_d);
+}
+
+bool wxSimpleJSON::View::WriteBinary(std::string &data) const
+{
+    return WriteToString(data, [this](const WriteCallback &sink)
+        { return WriteBinary(sink); });
+}
+
+// Compiled documents (see WriteCompiled() and MapFile())
+
+// A compiled document starts with this header, followed by its sections
+// (each starting at a multiple of 8 bytes), all in the machine's byte order:
+//  - nodes: a CompiledNode for each node, the root first. Nodes are stored
+//    breadth first, so the children of each array or object are next to each
+//    other (and after their parent).
+//  - keys: for each node, the offset of its name in the strings (or NoString).
+//  - order: for the children of each object, their positions sorted by name
+//    (ignoring the case of ASCII letters, then by position), at the same
+//    indices as the children themselves.
+//  - strings: each stored as its length (32 bits), its bytes and a null.
+struct CompiledHeader
+{
+    char m_magic[8];
+    uint32_t m_version;
+    // CompiledByteOrder, as written by the machine that compiled the document
+    uint32_t m_byteOrder;
+    uint64_t m_nodeCount;
+    uint64_t m_nodesOffset;
+    uint64_t m_keysOffset;
+    uint64_t m_orderOffset;
+    uint64_t m_stringsOffset;
+    uint64_t m_stringsSize;
+};
+
+struct CompiledNode
+{
+    // the node's cJSON type
+    uint32_t m_type;
+    // the number of children of an array or object
+    uint32_t m_count;
+    // a number's bits, the offset of a string (or raw text),
+    // or the index of an array or object's first child
+    uint64_t m_value;
+};
+
+static const char CompiledMagic[8] = { 'w', 'x', 'S', 'J', 'S', 'O', 'N', 'C' };
+static const uint32_t CompiledVersion = 1;
+static const uint32_t CompiledByteOrder = 0x01020304;
+static const uint64_t NoString = static_cast<uint64_t>(-1);
+
+// Objects with fewer properties than this are searched linearly rather than through their order.
+static const size_t CompiledSortedSearchSize = 8;
+
+// The section after one of count items of itemSize bytes at offset (padded to 8 bytes).
+static uint64_t CompiledSectionEnd(uint64_t offset, uint64_t count, uint64_t itemSize)
+{
+    return offset + (((count * itemSize) + 7) & ~static_cast<uint64_t>(7));
+}
+
+// Compares a name to a property name the way KeysEqualNoCase() matches them,
+// returning <0, 0 or >0 like strcmp().
+static int CompareKeysNoCase(const char *first, size_t firstLength,
+                             const char *second, size_t secondLength)
+{
+    const size_t length = std::min(firstLength, secondLength);
+    for (size_t i = 0; i < length; ++i) {
+        const int difference = tolower(static_cast<unsigned char>(first[i])) -
+                               tolower(static_cast<unsigned char>(second[i]));
+        if (difference != 0) {
+            return difference;
+        }
+    }
+    return (firstLength < secondLength) ? -1 : (firstLength > secondLength) ? 1 : 0;
+}
+
+// Writes a cJSON tree as a compiled document.
+class CompiledWriter
+{
+  public:
+    explicit CompiledWriter(const wxSimpleJSON::WriteCallback &sink) : m_out(sink) {}
+
+    bool Write(cJSON *root)
+    {
+        if (root == nullptr || !Layout(root)) {
+            return false;
+        }
+        const uint64_t nodeCount = m_nodes.size();
+        CompiledHeader header{};
+        memcpy(header.m_magic, CompiledMagic, sizeof(header.m_magic));
+        header.m_version = CompiledVersion;
+        header.m_byteOrder = CompiledByteOrder;
+        header.m_nodeCount = nodeCount;
+        header.m_nodesOffset = sizeof(CompiledHeader);
+        header.m_keysOffset = CompiledSectionEnd(header.m_nodesOffset, nodeCount, sizeof(CompiledNode));
+        header.m_orderOffset = CompiledSectionEnd(header.m_keysOffset, nodeCount, sizeof(uint64_t));
+        header.m_stringsOffset = CompiledSectionEnd(header.m_orderOffset, nodeCount, sizeof(uint32_t));
+        header.m_stringsSize = m_stringsSize;
+        m_out.Put(&header, sizeof(header));
+        WriteNodes();
+        WriteKeys();
+        WriteOrder();
+        WriteStrings();
+        return m_out.Flush();
+    }
+
+  private:
+    // Lists the nodes breadth first, returning false if something can't be stored.
+    bool Layout(cJSON *root)
+    {
+        m_nodes.push_back(Materialize(root));
+        for (size_t i = 0; i < m_nodes.size(); ++i) {
+            const cJSON *node = m_nodes[i];
+            if (!AddString(node->string)) {
+                return false;
+            }
+            const int type = NodeType(node);
+            if (type == cJSON_String || type == cJSON_Raw) {
+                if (!AddString(node->valuestring)) {
+                    return false;
+                }
+            }
+            size_t count{ 0 };
+            if (type == cJSON_Array || type == cJSON_Object) {
+                for (cJSON *child = node->child; child != nullptr; child = child->next) {
+                    m_nodes.push_back(Materialize(child));
+                    ++count;
+                }
+            }
+            if (count > UINT32_MAX) {
+                return false;
+            }
+            m_counts.push_back(static_cast<uint32_t>(count));
+        }
+        return true;
+    }
+
+    bool AddString(const char *text)
+    {
+        if (text == nullptr) {
+            return true;
+        }
+        const size_t length = strlen(text);
+        m_stringsSize += sizeof(uint32_t) + length + 1;
+        return (length <= UINT32_MAX);
+    }
+
+    // Returns the offset of text in the strings (or NoString), moving offset past it.
+    static uint64_t NextString(const char *text, uint64_t &offset)
+    {
+        if (text == nullptr) {
+            return NoString;
+        }
+        const uint64_t position = offset;
+        offset += sizeof(uint32_t) + strlen(text) + 1;
+        return position;
+    }
+
+    void Pad(uint64_t size)
+    {
+        static const char padding[8]{ 0 };
+        m_out.Put(padding, static_cast<size_t>((8 - (size % 8)) % 8));
+    }
+
+    void WriteNodes()
+    {
+        uint64_t stringOffset{ 0 };
+        uint64_t nextChild{ 1 };
+        for (size_t i = 0; i < m_nodes.size(); ++i) {
+            const cJSON *node = m_nodes[i];
+            CompiledNode compiled{};
+            compiled.m_type = static_cast<uint32_t>(NodeType(node));
+            NextString(node->string, stringOffset);
+            switch (compiled.m_type) {
+            case cJSON_Number:
+                memcpy(&compiled.m_value, &node->valuedouble, sizeof(compiled.m_value));
+                break;
+            case cJSON_String:
+            case cJSON_Raw:
+                compiled.m_value = NextString(node->valuestring, stringOffset);
+                break;
+            case cJSON_Array:
+            case cJSON_Object:
+                compiled.m_count = m_counts[i];
+                compiled.m_value = nextChild;
+                nextChild += m_counts[i];
+                break;
+            default:
+                break;
+            }
+            m_out.Put(&compiled, sizeof(compiled));
+        }
+        Pad(m_nodes.size() * sizeof(CompiledNode));
+    }
+
+    void WriteKeys()
+    {
+        uint64_t stringOffset{ 0 };
+        for (const cJSON *node : m_nodes) {
+            const uint64_t key = NextString(node->string, stringOffset);
+            m_out.Put(&key, sizeof(key));
+            const int type = NodeType(node);
+            if (type == cJSON_String || type == cJSON_Raw) {
+                NextString(node->valuestring, stringOffset);
+            }
+        }
+        Pad(m_nodes.size() * sizeof(uint64_t));
+    }
+
+    void WriteOrder()
+    {
+        // the root isn't anyone's child
+        const uint32_t rootPosition{ 0 };
+        m_out.Put(&rootPosition, sizeof(rootPosition));
+        size_t firstChild{ 1 };
+        std::vector<uint32_t> positions;
+        for (size_t i = 0; i < m_nodes.size(); ++i) {
+            const uint32_t count = m_counts[i];
+            positions.resize(count);
+            for (uint32_t position = 0; position < count; ++position) {
+                positions[position] = position;
+            }
+            if (NodeType(m_nodes[i]) == cJSON_Object) {
+                const cJSON *const *children = m_nodes.data() + firstChild;
+                std::sort(positions.begin(), positions.end(),
+                    [children](uint32_t first, uint32_t second)
+                    {
+                    const char *firstKey = (children[first]->string != nullptr) ?
+                                           children[first]->string : "";
+                    const char *secondKey = (children[second]->string != nullptr) ?
+                                            children[second]->string : "";
+                    const int order = CompareKeysNoCase(firstKey, strlen(firstKey),
+                                                        secondKey, strlen(secondKey));
+                    return (order < 0 || (order == 0 && first < second));
+                    });
+            }
+            if (count > 0) {
+                m_out.Put(positions.data(), count * sizeof(uint32_t));
+            }
+            firstChild += count;
+        }
+        Pad(m_nodes.size() * sizeof(uint32_t));
+    }
+
+    void WriteString(const char *text)
+    {
+        if (text != nullptr) {
+            const auto length = static_cast<uint32_t>(strlen(text));
+            m_out.Put(&length, sizeof(length));
+            m_out.Put(text, length + 1);
+        }
+    }
+
+    void WriteStrings()
+    {
+        for (const cJSON *node : m_nodes) {
+            WriteString(node->string);
+            const int type = NodeType(node);
+            if (type == cJSON_String || type == cJSON_Raw) {
+                WriteString(node->valuestring);
+            }
+        }
+    }
+
+    BufferedSink m_out;
+    // the nodes, in the order they are stored
+    std::vector<const cJSON *> m_nodes;
+    // the number of children of each node
+    std::vector<uint32_t> m_counts;
+    uint64_t m_stringsSize{ 0 };
+};
+
+// A compiled document, mapped (or read) into memory. Everything read from it is
+// checked against its bounds, so a damaged file reads as missing nodes rather than crashing.
+struct wxSimpleJSON::MappedStorage
+{
+    MappedStorage() = default;
+    MappedStorage(const MappedStorage&) = delete;
+    MappedStorage& operator=(const MappedStorage&) = delete;
+
+    ~MappedStorage()
+    {
+#if defined(__UNIX__)
+        if (m_mapping != nullptr) {
+            munmap(m_mapping, m_size);
+        }
+#elif defined(__WINDOWS__)
+        if (m_mapping != nullptr) {
+            ::UnmapViewOfFile(m_mapping);
+        }
+#endif
+    }
+
+    // Maps the file, returning false if it isn't a compiled document.
+    bool Map(const wxString &path)
+    {
+#if defined(__UNIX__)
+        const int fd = open(path.fn_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0 &&
+            static_cast<uint64_t>(info.st_size) <= SIZE_MAX) {
+            void *data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+            if (data != MAP_FAILED) {
+                m_mapping = data;
+                m_size = static_cast<size_t>(info.st_size);
+            }
+        }
+        close(fd);
+        return (m_mapping != nullptr && Open(m_mapping, m_size));
+#elif defined(__WINDOWS__)
+        const HANDLE file = ::CreateFileW(path.wc_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                          OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER size;
+        if (::GetFileSizeEx(file, &size) && size.QuadPart > 0 &&
+            static_cast<uint64_t>(size.QuadPart) <= SIZE_MAX) {
+            const HANDLE mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping != nullptr) {
+                m_mapping = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                m_size = static_cast<size_t>(size.QuadPart);
+                // the view keeps the mapping alive
+                ::CloseHandle(mapping);
+            }
+        }
+        ::CloseHandle(file);
+        return (m_mapping != nullptr && Open(m_mapping, m_size));
+#else
+        // without memory mapping, read the file into (8-byte aligned) memory
+        wxFFile fp(path, "rb");
+        const wxFileOffset length = fp.IsOpened() ? fp.Length() : -1;
+        if (length <= 0 || static_cast<uint64_t>(length) > SIZE_MAX) {
+            return false;
+        }
+        m_buffer.resize((static_cast<size_t>(length) + 7) / 8);
+        return (fp.Read(m_buffer.data(), static_cast<size_t>(length)) == static_cast<size_t>(length) &&
+                Open(m_buffer.data(), static_cast<size_t>(length)));
+#endif
+    }
+
+    // Checks the header and finds the sections.
+    bool Open(const void *data, size_t size)
+    {
+        CompiledHeader header;
+        if (size < sizeof(header)) {
+            return false;
+        }
+        memcpy(&header, data, sizeof(header));
+        const auto fits = [size](uint64_t offset, uint64_t count, uint64_t itemSize)
+            { return (offset % 8 == 0 && offset <= size && count <= (size - offset) / itemSize); };
+        if (memcmp(header.m_magic, CompiledMagic, sizeof(header.m_magic)) != 0 ||
+            header.m_version != CompiledVersion || header.m_byteOrder != CompiledByteOrder ||
+            header.m_nodeCount == 0 ||
+            !fits(header.m_nodesOffset, header.m_nodeCount, sizeof(CompiledNode)) ||
+            !fits(header.m_keysOffset, header.m_nodeCount, sizeof(uint64_t)) ||
+            !fits(header.m_orderOffset, header.m_nodeCount, sizeof(uint32_t)) ||
+            !fits(header.m_stringsOffset, header.m_stringsSize, 1)) {
+            return false;
+        }
+        const char *base = static_cast<const char *>(data);
+        m_nodes = reinterpret_cast<const CompiledNode *>(base + header.m_nodesOffset);
+        m_keys = reinterpret_cast<const uint64_t *>(base + header.m_keysOffset);
+        m_order = reinterpret_cast<const uint32_t *>(base + header.m_orderOffset);
+        m_strings = base + header.m_stringsOffset;
+        m_stringsSize = header.m_stringsSize;
+        m_nodeCount = static_cast<size_t>(header.m_nodeCount);
+        return true;
+    }
+
+    // Returns the string at offset, or a null view if it isn't one.
+    UTF8View String(uint64_t offset) const
+    {
+        if (offset >= m_stringsSize || m_stringsSize - offset < sizeof(uint32_t) + 1) {
+            return UTF8View();
+        }
+        uint32_t length{ 0 };
+        memcpy(&length, m_strings + offset, sizeof(length));
+        const uint64_t end = offset + sizeof(uint32_t) + length;
+        if (length > m_stringsSize - offset - sizeof(uint32_t) - 1 || m_strings[end] != 0) {
+            return UTF8View();
+        }
+        return UTF8View(m_strings + offset + sizeof(uint32_t), length);
+    }
+
+    // Finds an array or object's children, returning false if it has none.
+    bool GetChildren(size_t index, size_t &first, size_t &count) const
+    {
+        const CompiledNode &node = m_nodes[index];
+        if (node.m_type != cJSON_Array && node.m_type != cJSON_Object) {
+            return false;
+        }
+        // children are stored after their parent, so following them can't loop
+        if (node.m_value <= index || node.m_value > m_nodeCount ||
+            node.m_count > m_nodeCount - node.m_value) {
+            return false;
+        }
+        first = static_cast<size_t>(node.m_value);
+        count = node.m_count;
+        return (count > 0);
+    }
+
+    // Returns the index of an object's first property called name, or 0 if there is none.
+    size_t Find(size_t index, const UTF8View &name, bool caseSensitive) const
+    {
+        size_t first{ 0 }, count{ 0 };
+        if (m_nodes[index].m_type != cJSON_Object || !GetChildren(index, first, count)) {
+            return 0;
+        }
+        const auto matches = [&](size_t child)
+            {
+            const UTF8View key = String(m_keys[child]);
+            return (!key.IsNull() &&
+                    (caseSensitive ? key.Equals(name) : key.EqualsNoCase(name)));
+            };
+        if (count < CompiledSortedSearchSize) {
+            for (size_t child = first; child < first + count; ++child) {
+                if (matches(child)) {
+                    return child;
+                }
+            }
+            return 0;
+        }
+        // bisect the object's sorted order; names that only differ in case
+        // are next to each other, in the order of their positions
+        const uint32_t *order = m_order + first;
+        const auto compare = [&](size_t position)
+            {
+            const UTF8View key = (order[position] < count) ?
+                String(m_keys[first + order[position]]) : UTF8View();
+            return CompareKeysNoCase(key.data(), key.length(), name.data(), name.length());
+            };
+        size_t low{ 0 }, high{ count };
+        while (low < high) {
+            const size_t middle = low + (high - low) / 2;
+            if (compare(middle) < 0) {
+                low = middle + 1;
+            }
+            else {
+                high = middle;
+            }
+        }
+        for (; low < count && compare(low) == 0; ++low) {
+            if (matches(first + order[low])) {
+                return first + order[low];
+            }
+        }
+        return 0;
+    }
+
+    // Copies a node (and what is in it) into new cJSON nodes.
+    cJSON *Copy(size_t index, size_t depth) const
+    {
+        if (depth >= CJSON_NESTING_LIMIT) {
+            return nullptr;
+        }
+        const CompiledNode &node = m_nodes[index];
+        cJSON *item{ nullptr };
+        CountStatistic(NodesCreated);
+        switch (node.m_type) {
+        case cJSON_False:
+            item = cJSON_CreateFalse();
+            break;
+        case cJSON_True:
+            item = cJSON_CreateTrue();
+            break;
+        case cJSON_NULL:
+            item = cJSON_CreateNull();
+            break;
+        case cJSON_Number:
+            {
+            double value{ 0 };
+            memcpy(&value, &node.m_value, sizeof(value));
+            item = cJSON_CreateNumber(value);
+            break;
+            }
+        case cJSON_String:
+        case cJSON_Raw:
+            {
+            const auto text = String(node.m_value);
+            if (!text.IsNull()) {
+                item = (node.m_type == cJSON_String) ? cJSON_CreateString(text.data()) :
+                                                       cJSON_CreateRaw(text.data());
+            }
+            break;
+            }
+        case cJSON_Array:
+        case cJSON_Object:
+            {
+            item = (node.m_type == cJSON_Array) ? cJSON_CreateArray() : cJSON_CreateObject();
+            size_t first{ 0 }, count{ 0 };
+            if (item == nullptr || !GetChildren(index, first, count)) {
+                break;
+            }
+            for (size_t child = first; child < first + count; ++child) {
+                cJSON *copy = Copy(child, depth + 1);
+                const auto key = String(m_keys[child]);
+                if (copy != nullptr && !key.IsNull()) {
+                    copy->string = static_cast<char *>(cJSON_malloc(key.length() + 1));
+                    if (copy->string != nullptr) {
+                        memcpy(copy->string, key.data(), key.length() + 1);
+                    }
+                }
+                if (copy == nullptr || (!key.IsNull() && copy->string == nullptr)) {
+                    cJSON_Delete(copy);
+                    cJSON_Delete(item);
+                    return nullptr;
+                }
+                AppendChild(item, copy);
+            }
+            break;
+            }
+        default:
+            break;
+        }
+        return item;
+    }
+
+#if defined(__UNIX__) || defined(__WINDOWS__)
+    void *m_mapping{ nullptr };
+#else
+    std::vector<uint64_t> m_buffer;
+#endif
+    size_t m_size{ 0 };
+
+    const CompiledNode *m_nodes{ nullptr };
+    const uint64_t *m_keys{ nullptr };
+    const uint32_t *m_order{ nullptr };
+    const char *m_strings{ nullptr };
+    uint64_t m_stringsSize{ 0 };
+    size_t m_nodeCount{ 0 };
+};
+
+wxSimpleJSON::MappedNode wxSimpleJSON::MapFile(const wxFileName &filename)
+{
+    wxSharedPtr<MappedStorage> file(new MappedStorage);
+    return file->Map(filename.GetFullPath()) ? MappedNode(file, 0) : MappedNode();
+}
+
+bool wxSimpleJSON::WriteCompiled(const WriteCallback &sink) const
+{
+    return GetView().WriteCompiled(sink);
+}
+
+bool wxSimpleJSON::SaveCompiled(const wxFileName &filename) const
+{
+    wxFFile fp(filename.GetFullPath(), "wb");
+    if (!fp.IsOpened()) {
+        return false;
+    }
+    const bool written = WriteCompiled(FileSink(fp.fp()));
+    return (fp.Close() && written);
+}
+
+bool wxSimpleJSON::View::WriteCompiled(const WriteCallback &sink) const
+{
+    return CompiledWriter(sink).Write(m_d);
+}
+
+wxSimpleJSON::MappedNode wxSimpleJSON::Path::Evaluate(const MappedNode &root) const
+{
+    if (!m_ok) {
+        return MappedNode();
+    }
+    MappedNode node = root;
+    for (const auto &token : m_tokens) {
+        if (node.IsValueObject()) {
+            node = node.GetProperty(UTF8View(token.m_name.data(), token.m_name.length()), true);
+        }
+        else if (node.IsValueArray() && token.m_index != static_cast<size_t>(-1)) {
+            node = node.Item(token.m_index);
+        }
+        else {
+            return MappedNode();
+        }
+    }
+    return node;
+}
+
+wxSimpleJSON::JSONType wxSimpleJSON::MappedNode::GetType() const
+{
+    return IsOk() ? static_cast<JSONType>(m_file->m_nodes[m_index].m_type) : JSONType::IS_INVALID;
+}
+
+size_t wxSimpleJSON::MappedNode::ArraySize() const
+{
+    size_t first{ 0 }, count{ 0 };
+    return (IsValueArray() && m_file->GetChildren(m_index, first, count)) ? count : 0;
+}
+
+wxSimpleJSON::MappedNode wxSimpleJSON::MappedNode::Item(size_t index) const
+{
+    size_t first{ 0 }, count{ 0 };
+    if (!IsValueArray() || !m_file->GetChildren(m_index, first, count) || index >= count) {
+        return MappedNode();
+    }
+    return MappedNode(m_file, first + index);
+}
+
+wxSimpleJSON::MappedNode::iterator wxSimpleJSON::MappedNode::begin() const
+{
+    size_t first{ 0 }, count{ 0 };
+    if (IsNull() || !m_file->GetChildren(m_index, first, count)) {
+        return end();
+    }
+    return iterator(MappedNode(m_file, first));
+}
+
+wxSimpleJSON::MappedNode::iterator wxSimpleJSON::MappedNode::end() const
+{
+    size_t first{ 0 }, count{ 0 };
+    if (IsNull() || !m_file->GetChildren(m_index, first, count)) {
+        return iterator(MappedNode());
+    }
+    return iterator(MappedNode(m_file, first + count));
+}
+
+wxSimpleJSON::MappedNode wxSimpleJSON::MappedNode::GetProperty(const wxString &name,
+                                                               bool caseSensitive) const
+{
+    const wxScopedCharBuffer utf8 = ToMultiByte(name, wxConvUTF8);
+    return GetProperty(UTF8View(utf8.data(), utf8.length()), caseSensitive);
+}
+
+wxSimpleJSON::MappedNode wxSimpleJSON::MappedNode::GetProperty(const char *name,
+                                                               bool caseSensitive) const
+{
+    return (name != nullptr) ? GetProperty(UTF8View(name), caseSensitive) : MappedNode();
+}
+
+wxSimpleJSON::MappedNode wxSimpleJSON::MappedNode::GetProperty(const UTF8View &name,
+                                                               bool caseSensitive) const
+{
+    if (IsNull() || name.IsNull()) {
+        return MappedNode();
+    }
+    const size_t index = m_file->Find(m_index, name, caseSensitive);
+    return (index != 0) ? MappedNode(m_file, index) : MappedNode();
+}
+
+wxArrayString wxSimpleJSON::MappedNode::GetObjectKeys(const wxMBConv &conv) const
+{
+    wxArrayString keys;
+    for (const auto &key : GetObjectKeysUTF8()) {
+        keys.Add(wxString(key.data(), conv));
+    }
+    return keys;
+}
+
+std::vector<wxSimpleJSON::UTF8View> wxSimpleJSON::MappedNode::GetObjectKeysUTF8() const
+{
+    std::vector<UTF8View> keys;
+    if (!IsValueObject()) {
+        return keys;
+    }
+    keys.reserve(std::distance(begin(), end()));
+    for (const auto &child : *this) {
+        const auto key = child.GetNameUTF8();
+        if (!key.IsNull()) {
+            keys.push_back(key);
+        }
+    }
+    return keys;
+}
+
+wxSimpleJSON::UTF8View wxSimpleJSON::MappedNode::GetNameUTF8() const
+{
+    return IsOk() ? m_file->String(m_file->m_keys[m_index]) : UTF8View();
+}
+
+wxString wxSimpleJSON::MappedNode::GetValueString(const wxString &defaultValue,
+                                                  const wxMBConv &conv) const
+{
+    const auto text = GetValueStringUTF8();
+    return text.IsNull() ? defaultValue : wxString(text.data(), conv);
+}
+
+wxSimpleJSON::UTF8View wxSimpleJSON::MappedNode::GetValueStringUTF8() const
+{
+    return IsValueString() ? m_file->String(m_file->m_nodes[m_index].m_value) : UTF8View();
+}
+
+bool wxSimpleJSON::MappedNode::GetValueBool(bool defaultValue) const
+{
+    return IsValueBoolean() ? (GetType() == JSONType::IS_TRUE) : defaultValue;
+}
+
+double wxSimpleJSON::MappedNode::GetValueNumber(double defaultValue) const
+{
+    if (!IsValueNumber()) {
+        return defaultValue;
+    }
+    double value{ 0 };
+    memcpy(&value, &m_file->m_nodes[m_index].m_value, sizeof(value));
+    return value;
+}
+
+std::vector<bool> wxSimpleJSON::MappedNode::GetValueArrayBool(bool defaultValue) const
+{
+    std::vector<bool> arr;
+    arr.reserve(ArraySize());
+    if (IsValueArray()) {
+        for (const auto &item : *this) {
+            arr.push_back(item.GetValueBool(defaultValue));
+        }
+    }
+    return arr;
+}
+
+wxArrayString wxSimpleJSON::MappedNode::GetValueArrayString(const wxMBConv &conv) const
+{
+    wxArrayString arr;
+    arr.reserve(ArraySize());
+    if (IsValueArray()) {
+        for (const auto &item : *this) {
+            arr.Add(item.GetValueString(wxEmptyString, conv));
+        }
+    }
+    return arr;
+}
+
+std::vector<wxSimpleJSON::UTF8View> wxSimpleJSON::MappedNode::GetValueArrayStringUTF8() const
+{
+    std::vector<UTF8View> arr;
+    arr.reserve(ArraySize());
+    if (IsValueArray()) {
+        for (const auto &item : *this) {
+            arr.push_back(item.GetValueStringUTF8());
+        }
+    }
+    return arr;
+}
+
+std::vector<double> wxSimpleJSON::MappedNode::GetValueArrayNumber(double defaultValue) const
+{
+    std::vector<double> arr;
+    arr.reserve(ArraySize());
+    if (IsValueArray()) {
+        for (const auto &item : *this) {
+            arr.push_back(item.GetValueNumber(defaultValue));
+        }
+    }
+    return arr;
+}
+
+wxSimpleJSON::Ptr_t wxSimpleJSON::MappedNode::Copy() const
+{
+    return Create(IsOk() ? m_file->Copy(m_index, 0) : nullptr, true);
+}
+
+// Bindings (see wxSimpleJSON::To() and From())
+
+// Bound types with fewer fields than this are searched linearly rather than through their order.
+static const size_t BindingSortedSearchSize = 8;
+
+// Orders names by length, then bytes (which is all that matching needs).
+static bool BindingNameLess(const wxSimpleJSON::UTF8View &first,
+                            const wxSimpleJSON::UTF8View &second)
+{
+    if (first.length() != second.length()) {
+        return first.length() < second.length();
+    }
+    return std::memcmp(first.data(), second.data(), first.length()) < 0;
+}
+
+static bool BindingNameEquals(const wxSimpleJSON::UTF8View &name, const char *key, size_t length)
+{
+    return name.length() == length && std::memcmp(name.data(), key, length) == 0;
+}
+
+void wxSimpleJSON::BindingReader::Keys::Sort()
+{
+    m_order.resize(m_names.size());
+    for (size_t i = 0; i < m_order.size(); ++i) {
+        m_order[i] = i;
+    }
+    std::sort(m_order.begin(), m_order.end(), [this](size_t first, size_t second)
+        { return BindingNameLess(m_names[first], m_names[second]); });
+}
+
+size_t wxSimpleJSON::BindingReader::Keys::Find(const char *name, size_t length, size_t hint) const
+{
+    // properties usually come in the binding's order (as From() writes them)
+    if (hint < m_names.size() && BindingNameEquals(m_names[hint], name, length)) {
+        return hint;
+    }
+    if (m_names.size() < BindingSortedSearchSize) {
+        for (size_t i = 0; i < m_names.size(); ++i) {
+            if (BindingNameEquals(m_names[i], name, length)) {
+                return i;
+            }
+        }
+        return m_names.size();
+    }
+    const UTF8View key(name, length);
+    const auto found = std::lower_bound(m_order.cbegin(), m_order.cend(), key,
+        [this](size_t index, const UTF8View &value) { return BindingNameLess(m_names[index], value); });
+    return (found != m_order.cend() && BindingNameEquals(m_names[*found], name, length)) ?
+        *found : m_names.size();
+}
+
+wxSimpleJSON::BindingReader::BindingReader(const cJSON *node, const Keys &keys)
+    : m_matches(m_inlineMatches)
+{
+    const size_t count = keys.size();
+    if (count > sizeof(m_inlineMatches) / sizeof(m_inlineMatches[0])) {
+        m_matches = new const cJSON *[count];
+    }
+    std::fill(m_matches, m_matches + count, nullptr);
+    node = Materialize(const_cast<cJSON *>(node));
+    if (node == nullptr || NodeType(node) != cJSON_Object) {
+        m_ok = false;
+        return;
+    }
+    size_t hint{ 0 };
+    size_t steps{ 0 };
+    for (const cJSON *child = node->child; child != nullptr; child = child->next, ++steps) {
+        if (child->string == nullptr) {
+            continue;
+        }
+        const size_t field = keys.Find(child->string, strlen(child->string), hint);
+        if (field < count) {
+            // like GetProperty(), the first of duplicate properties is the one read
+            if (m_matches[field] == nullptr) {
+                m_matches[field] = child;
+            }
+            hint = field + 1;
+        }
+    }
+    CountStatistic(KeyScanSteps, steps);
+}
+
+wxSimpleJSON::BindingReader::~BindingReader()
+{
+    if (m_matches != m_inlineMatches) {
+        delete[] m_matches;
+    }
+}
+
+bool wxSimpleJSON::BindingReader::Read(const cJSON *node, bool &value)
+{
+    if (NodeType(node) != cJSON_True && NodeType(node) != cJSON_False) {
+        return false;
+    }
+    value = (NodeType(node) == cJSON_True);
+    return true;
+}
+
+bool wxSimpleJSON::BindingReader::Read(const cJSON *node, double &value)
+{
+    if (NodeType(node) != cJSON_Number) {
+        return false;
+    }
+    value = node->valuedouble;
+    return true;
+}
+
+bool wxSimpleJSON::BindingReader::Read(const cJSON *node, std::string &value)
+{
+    if (NodeType(node) != cJSON_String || node->valuestring == nullptr) {
+        return false;
+    }
+    value.assign(node->valuestring);
+    return true;
+}
+
+bool wxSimpleJSON::BindingReader::Read(const cJSON *node, wxString &value)
+{
+    if (NodeType(node) != cJSON_String || node->valuestring == nullptr) {
+        return false;
+    }
+    value = wxString(node->valuestring, wxConvUTF8);
+    return true;
+}
+
+bool wxSimpleJSON::BindingReader::ReadInteger(const cJSON *node, bool isSigned, int digits,
+                                              double &value)
+{
+    if (!Read(node, value)) {
+        return false;
+    }
+    // [-2^digits, 2^digits) for signed types, [0, 2^digits) for unsigned ones
+    const double limit = std::ldexp(1.0, digits);
+    return (std::trunc(value) == value && value < limit && value >= (isSigned ? -limit : 0.0));
+}
+
+bool wxSimpleJSON::BindingReader::GetFirstItem(const cJSON *node, const cJSON *&item)
+{
+    node = Materialize(const_cast<cJSON *>(node));
+    if (node == nullptr || NodeType(node) != cJSON_Array) {
+        return false;
+    }
+    item = node->child;
+    return true;
+}
+
+const cJSON *wxSimpleJSON::BindingReader::GetNextItem(const cJSON *item)
+{
+    return item->next;
+}
+
+wxSimpleJSON::BindingWriter::BindingWriter()
+    : m_root(wxSimpleJSON::Create(IS_OBJECT, true)), m_node(m_root->m_d)
+{
+}
+
+wxSimpleJSON::BindingWriter::BindingWriter(BindingWriter &parent, const char *name, bool isArray)
+{
+    cJSON *item = isArray ? cJSON_CreateArray() : cJSON_CreateObject();
+    if (parent.Append(name, item)) {
+        m_node = item;
+    }
+}
+
+void wxSimpleJSON::BindingWriter::Write(const char *name, bool value)
+{
+    Append(name, cJSON_CreateBool(value));
+}
+
+void wxSimpleJSON::BindingWriter::Write(const char *name, double value)
+{
+    Append(name, cJSON_CreateNumber(value));
+}
+
+void wxSimpleJSON::BindingWriter::Write(const char *name, const std::string &value)
+{
+    Append(name, cJSON_CreateString(value.c_str()));
+}
+
+void wxSimpleJSON::BindingWriter::Write(const char *name, const wxString &value)
+{
+    Append(name, cJSON_CreateString(ToMultiByte(value, wxConvUTF8).data()));
+}
+
+bool wxSimpleJSON::BindingWriter::Append(const char *name, cJSON *item)
+{
+    if (item == nullptr) {
+        return false;
+    }
+    if (m_node == nullptr) {
+        cJSON_Delete(item);
+        return false;
+    }
+    if (name != nullptr) {
+        // the binding's names outlive the document, so they are used as they are
+        item->string = const_cast<char *>(name);
+        item->type |= cJSON_StringIsConst;
+    }
+    // append in constant time (the names of a binding are unique)
+    if (m_tail == nullptr) {
+        m_node->child = item;
+    }
+    else {
+        m_tail->next = item;
+        item->prev = m_tail;
+    }
+    m_node->child->prev = item;
+    m_tail = item;
+    CountStatistic(NodesCreated);
+    return true;
+}
+
+// Schemas (see wxSimpleJSON::Validate())
+
+// Allows integers (numbers without a fraction) in Schema::Node::m_types.
+static const int SchemaIntegerType = 1 << 8;
+static const int SchemaAnyType = 0xFF | SchemaIntegerType;
+
+// Object schemas with fewer properties than this are searched linearly rather than through their order.
+static const size_t SchemaSortedSearchSize = 8;
+
+// Appends a property name to a JSON Pointer, escaping it (RFC 6901).
+static void AppendPointerToken(std::string &pointer, const char *name)
+{
+    pointer += '/';
+    for (const char *p = name; *p != 0; ++p) {
+        if (*p == '~') {
+            pointer += "~0";
+        }
+        else if (*p == '/') {
+            pointer += "~1";
+        }
+        else {
+            pointer += *p;
+        }
+    }
+}
+
+// The number of code points in UTF-8 text (which JSON Schema's lengths count).
+static size_t CountCodePoints(const char *text)
+{
+    size_t count{ 0 };
+    for (const char *p = text; *p != 0; ++p) {
+        count += ((static_cast<unsigned char>(*p) & 0xC0) != 0x80) ? 1 : 0;
+    }
+    return count;
+}
+
+struct wxSimpleJSON::Schema::Validation
+{
+    // for each property, the number of the last object it was found in
+    std::vector<uint32_t> m_found;
+    uint32_t m_objects{ 0 };
+    // where (built while returning from the failed node) and why validation failed
+    std::string m_path;
+    wxString m_message;
+};
+
+wxSimpleJSON::Schema::Schema(const View &definition)
+{
+    Compile(definition, wxString());
+    if (!IsOk()) {
+        m_nodes.clear();
+        m_properties.clear();
+        m_enumValues.clear();
+    }
+}
+
+// Compiles a (sub)schema, which is at path in the definition. Returns its index in m_nodes.
+size_t wxSimpleJSON::Schema::Compile(const View &definition, const wxString &path)
+{
+    const size_t index = m_nodes.size();
+    m_nodes.emplace_back();
+    Node node;
+    const auto fail = [this, &path](const wxString &message)
+        {
+        if (m_error.empty()) {
+            m_error = path.empty() ? message : path + L": " + message;
+        }
+        };
+    if (definition.IsValueBoolean()) {
+        m_nodes[index].m_types = definition.GetValueBool() ? SchemaAnyType : 0;
+        return index;
+    }
+    if (!definition.IsValueObject()) {
+        fail(L"a schema must be an object or a boolean");
+        return index;
+    }
+    node.m_types = SchemaAnyType;
+
+    const View type = definition.GetProperty("type", true);
+    if (type.IsOk()) {
+        std::vector<View> names;
+        if (type.IsValueArray()) {
+            names = type.GetValueArrayObject();
+        }
+        else {
+            names.push_back(type);
+        }
+        node.m_types = 0;
+        for (const auto &name : names) {
+            const UTF8View text = name.GetValueStringUTF8();
+            if (text.Equals("null", 4)) {
+                node.m_types |= cJSON_NULL;
+            }
+            else if (text.Equals("boolean", 7)) {
+                node.m_types |= cJSON_True | cJSON_False;
+            }
+            else if (text.Equals("number", 6)) {
+                node.m_types |= cJSON_Number | SchemaIntegerType;
+            }
+            else if (text.Equals("integer", 7)) {
+                node.m_types |= SchemaIntegerType;
+            }
+            else if (text.Equals("string", 6)) {
+                node.m_types |= cJSON_String;
+            }
+            else if (text.Equals("array", 5)) {
+                node.m_types |= cJSON_Array;
+            }
+            else if (text.Equals("object", 6)) {
+                node.m_types |= cJSON_Object;
+            }
+            else {
+                fail(L"unknown type in \"type\"");
+            }
+        }
+    }
+
+    // the allowed values
+    std::vector<View> values;
+    const View enumValues = definition.GetProperty("enum", true);
+    if (enumValues.IsOk()) {
+        if (!enumValues.IsValueArray()) {
+            fail(L"\"enum\" must be an array");
+        }
+        values = enumValues.GetValueArrayObject();
+        node.m_hasEnum = true;
+    }
+    const View constValue = definition.GetProperty("const", true);
+    if (constValue.IsOk()) {
+        values.assign(1, constValue);
+        node.m_hasEnum = true;
+    }
+    node.m_firstEnumValue = m_enumValues.size();
+    for (const auto &value : values) {
+        EnumValue allowed;
+        allowed.m_type = value.m_type;
+        if (value.IsValueNumber()) {
+            allowed.m_number = value.GetValueNumber();
+        }
+        else if (value.IsValueString()) {
+            allowed.m_text.assign(value.GetText().data(), value.GetText().length());
+        }
+        else if (!value.IsValueNull() && !value.IsValueBoolean()) {
+            fail(L"only null, boolean, number and string values are supported in \"enum\" and \"const\"");
+        }
+        m_enumValues.push_back(allowed);
+    }
+    node.m_enumValueCount = m_enumValues.size() - node.m_firstEnumValue;
+
+    // numbers
+    const auto readNumber = [&definition, &fail](const char *keyword, double &value, bool *exclusive)
+        {
+        const View number = definition.GetProperty(keyword, true);
+        if (number.IsValueNumber()) {
+            value = number.GetValueNumber();
+            return true;
+        }
+        if (exclusive != nullptr && number.IsValueBoolean()) {
+            // the boolean form of draft 4
+            *exclusive = number.GetValueBool();
+        }
+        else if (number.IsOk()) {
+            fail(wxString::Format(L"\"%s\" must be a number", keyword));
+        }
+        return false;
+        };
+    readNumber("minimum", node.m_minimum, nullptr);
+    readNumber("maximum", node.m_maximum, nullptr);
+    double limit{ 0 };
+    if (readNumber("exclusiveMinimum", limit, &node.m_exclusiveMinimum) && limit >= node.m_minimum) {
+        node.m_minimum = limit;
+        node.m_exclusiveMinimum = true;
+    }
+    if (readNumber("exclusiveMaximum", limit, &node.m_exclusiveMaximum) && limit <= node.m_maximum) {
+        node.m_maximum = limit;
+        node.m_exclusiveMaximum = true;
+    }
+
+    // lengths and counts
+    const auto readCount = [&readNumber](const char *keyword, size_t &count)
+        {
+        double value{ 0 };
+        if (readNumber(keyword, value, nullptr)) {
+            count = (value <= 0) ? 0 :
+                (value >= static_cast<double>(SIZE_MAX)) ? SIZE_MAX : static_cast<size_t>(value);
+        }
+        };
+    readCount("minLength", node.m_minLength);
+    readCount("maxLength", node.m_maxLength);
+    readCount("minItems", node.m_minItems);
+    readCount("maxItems", node.m_maxItems);
+
+    const View items = definition.GetProperty("items", true);
+    if (items.IsValueObject() || items.IsValueBoolean()) {
+        node.m_items = Compile(items, path + L"/items");
+    }
+
+    // properties (compiled first, because their schemas add their own properties)
+    std::vector<Property> properties;
+    const View propertyDefinitions = definition.GetProperty("properties", true);
+    if (propertyDefinitions.IsOk() && !propertyDefinitions.IsValueObject()) {
+        fail(L"\"properties\" must be an object");
+    }
+    for (const auto &property : propertyDefinitions) {
+        const UTF8View name = property.GetNameUTF8();
+        std::string pointer;
+        AppendPointerToken(pointer, name.data());
+        Property compiled;
+        compiled.m_name.assign(name.data(), name.length());
+        compiled.m_node = Compile(property, path + L"/properties" + wxString::FromUTF8(pointer.c_str()));
+        properties.push_back(compiled);
+    }
+    const View required = definition.GetProperty("required", true);
+    if (required.IsOk() && !required.IsValueArray()) {
+        fail(L"\"required\" must be an array");
+    }
+    for (const auto &name : required) {
+        if (!name.IsValueString()) {
+            fail(L"\"required\" must be an array of strings");
+            continue;
+        }
+        const UTF8View text = name.GetText();
+        auto found = std::find_if(properties.begin(), properties.end(), [&text](const Property &property)
+            { return BindingNameEquals(UTF8View(property.m_name.data(), property.m_name.length()), text.data(), text.length()); });
+        if (found == properties.end()) {
+            // required, but its value can be anything
+            properties.emplace_back();
+            found = properties.end() - 1;
+            found->m_name.assign(text.data(), text.length());
+        }
+        if (!found->m_required) {
+            found->m_required = true;
+            ++node.m_requiredCount;
+        }
+    }
+    std::sort(properties.begin(), properties.end(), [](const Property &first, const Property &second)
+        {
+        return BindingNameLess(UTF8View(first.m_name.data(), first.m_name.length()),
+                               UTF8View(second.m_name.data(), second.m_name.length()));
+        });
+    node.m_firstProperty = m_properties.size();
+    node.m_propertyCount = properties.size();
+    m_properties.insert(m_properties.end(), properties.begin(), properties.end());
+
+    const View additional = definition.GetProperty("additionalProperties", true);
+    if (additional.IsValueObject() || additional.IsValueBoolean()) {
+        node.m_additionalProperties = Compile(additional, path + L"/additionalProperties");
+    }
+
+    m_nodes[index] = node;
+    return index;
+}
+
+bool wxSimpleJSON::Schema::Validate(const View &node, wxString *error) const
+{
+    if (!IsOk()) {
+        if (error != nullptr) {
+            *error = m_error;
+        }
+        return false;
+    }
+    if (m_nodes.empty()) {
+        return true;
+    }
+    Validation validation;
+    if (node.IsOk()) {
+        validation.m_found.assign(m_properties.size(), 0);
+        if (ValidateNode(0, node.m_d, validation)) {
+            return true;
+        }
+    }
+    else {
+        validation.m_message = L"the node is invalid";
+    }
+    if (error != nullptr) {
+        *error = validation.m_path.empty() ? validation.m_message :
+            wxString::FromUTF8(validation.m_path.c_str()) + L": " + validation.m_message;
+    }
+    return false;
+}
+
+// Checks a node (which has been parsed) against the schema at index. On failure,
+// the node's path is added to validation.m_path by each of its containers in turn.
+bool wxSimpleJSON::Schema::ValidateNode(size_t index, const cJSON *node, Validation &validation) const
+{
+    if (index == NoNode) {
+        return true;
+    }
+    const Node &schema = m_nodes[index];
+    const int type = NodeType(node);
+    if (!(schema.m_types & type)) {
+        // numbers can be allowed only if they are integers
+        if (type != cJSON_Number || !(schema.m_types & SchemaIntegerType) ||
+            std::trunc(node->valuedouble) != node->valuedouble) {
+            validation.m_message = (schema.m_types == 0) ? L"no value is allowed here" : L"wrong type";
+            return false;
+        }
+    }
+
+    switch (type) {
+    case cJSON_Number:
+        {
+        const double value = node->valuedouble;
+        if (value < schema.m_minimum || (schema.m_exclusiveMinimum && value == schema.m_minimum)) {
+            validation.m_message = L"number is too small";
+            return false;
+        }
+        if (value > schema.m_maximum || (schema.m_exclusiveMaximum && value == schema.m_maximum)) {
+            validation.m_message = L"number is too large";
+            return false;
+        }
+        break;
+        }
+    case cJSON_String:
+        if (schema.m_minLength > 0 || schema.m_maxLength != SIZE_MAX) {
+            const size_t length = CountCodePoints(node->valuestring);
+            if (length < schema.m_minLength || length > schema.m_maxLength) {
+                validation.m_message = (length < schema.m_minLength) ? L"string is too short" : L"string is too long";
+                return false;
+            }
+        }
+        break;
+    case cJSON_Array:
+        {
+        size_t count{ 0 };
+        for (const cJSON *item = node->child; item != nullptr; item = item->next, ++count) {
+            if (!ValidateNode(schema.m_items, Materialize(const_cast<cJSON *>(item)), validation)) {
+                validation.m_path.insert(0, "/" + std::to_string(count));
+                return false;
+            }
+        }
+        if (count < schema.m_minItems || count > schema.m_maxItems) {
+            validation.m_message = (count < schema.m_minItems) ? L"too few items" : L"too many items";
+            return false;
+        }
+        break;
+        }
+    case cJSON_Object:
+        {
+        const uint32_t object = ++validation.m_objects;
+        const Property *first = m_properties.data() + schema.m_firstProperty;
+        const Property *last = first + schema.m_propertyCount;
+        size_t requiredCount{ 0 };
+        size_t steps{ 0 };
+        for (const cJSON *child = node->child; child != nullptr; child = child->next, ++steps) {
+            const size_t length = strlen(child->string);
+            const Property *property = last;
+            if (schema.m_propertyCount < SchemaSortedSearchSize) {
+                property = std::find_if(first, last, [child, length](const Property &candidate)
+                    { return candidate.m_name.length() == length && candidate.m_name == child->string; });
+            }
+            else {
+                const UTF8View name(child->string, length);
+                property = std::lower_bound(first, last, name, [](const Property &candidate, const UTF8View &value)
+                    { return BindingNameLess(UTF8View(candidate.m_name.data(), candidate.m_name.length()), value); });
+                if (property != last && !BindingNameEquals(UTF8View(property->m_name.data(), property->m_name.length()),
+                                                           child->string, length)) {
+                    property = last;
+                }
+            }
+            size_t childSchema = schema.m_additionalProperties;
+            if (property != last) {
+                childSchema = property->m_node;
+                uint32_t &found = validation.m_found[property - m_properties.data()];
+                if (property->m_required && found != object) {
+                    ++requiredCount;
+                }
+                found = object;
+            }
+            else if (childSchema != NoNode && m_nodes[childSchema].m_types == 0) {
+                validation.m_message = wxString::Format(L"unexpected property \"%s\"", wxString::FromUTF8(child->string));
+                return false;
+            }
+            if (!ValidateNode(childSchema, Materialize(const_cast<cJSON *>(child)), validation)) {
+                std::string token;
+                AppendPointerToken(token, child->string);
+                validation.m_path.insert(0, token);
+                return false;
+            }
+        }
+        CountStatistic(KeyScanSteps, steps);
+        if (requiredCount < schema.m_requiredCount) {
+            for (const Property *property = first; property != last; ++property) {
+                if (property->m_required && validation.m_found[property - m_properties.data()] != object) {
+                    validation.m_message = wxString::Format(L"missing required property \"%s\"",
+                                                            wxString::FromUTF8(property->m_name.c_str()));
+                    break;
+                }
+            }
+            return false;
+        }
+        break;
+        }
+    default:
+        break;
+    }
+
+    if (schema.m_hasEnum) {
+        const EnumValue *first = m_enumValues.data() + schema.m_firstEnumValue;
+        const EnumValue *last = first + schema.m_enumValueCount;
+        const bool allowed = std::any_of(first, last, [node, type](const EnumValue &value)
+            {
+            return value.m_type == type &&
+                (type != cJSON_Number || value.m_number == node->valuedouble) &&
+                (type != cJSON_String || value.m_text == node->valuestring);
+            });
+        if (!allowed) {
+            validation.m_message = L"value is not one of the allowed values";
+            return false;
+        }
+    }
+    return true;
 }
 
-wxString wxSimpleJSON::Print(bool pretty, const wxMBConv &conv) const
+bool wxSimpleJSON::View::Validate(const Schema &schema, wxString *error) const
+{
+    return schema.Validate(*this, error);
+}
+
+bool wxSimpleJSON::Validate(const Schema &schema, wxString *error) const
+{
+    return GetView().Validate(schema, error);
+}
+
+// wxSimpleJSON::Document
+
+wxSimpleJSON::Document::~Document() {}
+
+// Gets the arena and the root's handle ready for a new document,
+// reusing them unless the previous document is still referred to.
+void wxSimpleJSON::Document::Recycle()
+{
+    if (m_root.get() != nullptr && m_root.unique()) {
+        m_root->ResetHandle();
+    }
+    else {
+        m_root.reset();
+    }
+    if (m_storage.get() != nullptr && m_storage.unique()) {
+        m_storage->m_arena.Reset();
+    }
+    else {
+        m_storage.reset();
+    }
+}
+
+wxSimpleJSON::Ptr_t wxSimpleJSON::Document::Parse(const char *data, size_t length)
+{
+    return ParseEncoded(data, length, wxConvUTF8);
+}
+
+wxSimpleJSON::Ptr_t wxSimpleJSON::Document::Parse(const wxString &text, const wxMBConv &conv)
+{
+    const auto buffer = ToMultiByte(text, conv);
+    return ParseEncoded(buffer.data(), buffer.length(), conv);
+}
+
+wxSimpleJSON::Ptr_t wxSimpleJSON::Document::ParseEncoded(const char *data, size_t length,
+                                                         const wxMBConv &conv)
+{
+    Recycle();
+    if (m_storage.get() == nullptr) {
+        m_storage.reset(new DocumentStorage);
+    }
+    if (m_root.get() == nullptr) {
+        m_root = Create(nullptr, true);
+    }
+
+    const StatisticsTimer timer(Parses, ParseNanoseconds);
+    CountStatistic(BytesParsed, length);
+    const ArenaScope scope(m_storage);
+    const char *parseEnd{ nullptr };
+    cJSON *p = ParseDocument(data, length, parseEnd);
+    m_root->m_d = p;
+    m_root->m_canDelete = true;
+    if (p != nullptr) {
+        m_root->m_storage = m_storage;
+    }
+    else if (data != nullptr) {
+        m_root->SetLastError(FormatParseError(data, data + length, parseEnd, conv));
+    }
+    return m_root;
+}
+
+wxSimpleJSON::Ptr_t wxSimpleJSON::Document::GetRoot() const
+{
+    return (m_root.get() != nullptr) ? m_root : Create(nullptr, true);
+}
+
+void wxSimpleJSON::Document::Clear()
+{
+    Recycle();
+}
+
+// wxSimpleJSON::EventReader
+
+// Incremental parser behind wxSimpleJSON::EventReader. Reads through a
+// fixed-size buffer (or straight from the caller's memory), accepting the same
+// syntax as cJSON_Parse() and keeping track of lines for error messages.
+class EventParser
+{
+  public:
+    using ReadFunction = std::function<size_t(char *buffer, size_t size)>;
+
+    EventParser(wxSimpleJSON::EventHandler &handler, const ReadFunction &read, size_t bufferSize)
+        : m_handler(handler), m_read(read), m_storage(bufferSize)
+    {
+        m_data = m_storage.data();
+    }
+
+    EventParser(wxSimpleJSON::EventHandler &handler, const char *data, size_t length)
+        : m_handler(handler), m_data(data), m_end(length)
+    {
+    }
+
+    // Returns true if the whole document was parsed; on failure, error is
+    // set unless the handler stopped parsing (by returning false from an event).
+    bool Parse(wxString &error)
+    {
+        error.clear();
+        // skip a UTF-8 byte order mark, like cJSON
+        // (its first byte can't start a JSON value anyway)
+        if (Peek() == 0xEF) {
+            Advance();
+            for (const int c : { 0xBB, 0xBF }) {
+                if (Peek() != c) {
+                    Fail(Offset());
+                    error = FormatError();
+                    return false;
+                }
+                Advance();
+            }
+        }
+        if (ParseValue(0)) {
+            SkipWhitespace();
+            if (Peek() < 0) {
+                return true;
+            }
+            Fail(Offset());
+        }
+        if (m_failed) {
+            error = FormatError();
+        }
+        return false;
+    }
+
+  private:
+    size_t Offset() const { return m_bufferOffset + m_pos; }
+
+    // Returns the next byte (without consuming it), or -1 at the end of the input.
+    int Peek()
+    {
+        if (m_pos == m_end && !Refill()) {
+            return -1;
+        }
+        return static_cast<unsigned char>(m_data[m_pos]);
+    }
+
+    // Consumes the byte returned from Peek().
+    void Advance()
+    {
+        if (m_data[m_pos] == '\n') {
+            ++m_lineCount;
+            m_lineStart = Offset() + 1;
+        }
+        ++m_pos;
+    }
+
+    bool Refill()
+    {
+        if (!m_read || m_eof) {
+            return false;
+        }
+        // keep the start of the current line (up to a quarter of the buffer)
+        // so that it can be quoted in error messages
+        const size_t lineStart = (m_lineStart > m_bufferOffset) ? m_lineStart - m_bufferOffset : 0;
+        const size_t keep = std::min(m_end - std::min(lineStart, m_end), m_storage.size() / 4);
+        memmove(m_storage.data(), m_storage.data() + m_end - keep, keep);
+        m_bufferOffset += m_end - keep;
+        const size_t count = m_read(m_storage.data() + keep, m_storage.size() - keep);
+        m_pos = keep;
+        m_end = keep + count;
+        m_eof = (count == 0);
+        return !m_eof;
+    }
+
+    bool Fail(size_t offset)
+    {
+        if (!m_failed) {
+            m_failed = true;
+            m_errorOffset = offset;
+        }
+        return false;
+    }
+
+    wxString FormatError() const
+    {
+        // only the part of the line still in the buffer can be quoted
+        const char *parseEnd = m_data + ((m_errorOffset > m_bufferOffset) ?
+            std::min(m_errorOffset - m_bufferOffset, m_end) : 0);
+        const char *lineBegin = std::min(parseEnd, m_data + ((m_lineStart > m_bufferOffset) ?
+            std::min(m_lineStart - m_bufferOffset, m_end) : 0));
+        return FormatParseError(m_lineCount, m_errorOffset - std::min(m_lineStart, m_errorOffset),
+                                lineBegin, parseEnd, m_data + m_end, wxConvUTF8);
+    }
+
+    void SkipWhitespace()
+    {
+        for (int c = Peek(); c >= 0 && c <= 32; c = Peek()) {
+            Advance();
+        }
+    }
+
+    bool ParseValue(size_t depth)
+    {
+        SkipWhitespace();
+        const int c = Peek();
+        switch (c) {
+        case '{':
+            return ParseObject(depth);
+        case '[':
+            return ParseArray(depth);
+        case '"':
+            return ParseString(m_token) && m_handler.OnString(m_token.data(), m_token.length());
+        case 't':
+            return ParseLiteral("true", 4) && m_handler.OnBool(true);
+        case 'f':
+            return ParseLiteral("false", 5) && m_handler.OnBool(false);
+        case 'n':
+            return ParseLiteral("null", 4) && m_handler.OnNull();
+        default:
+            if (c == '-' || (c >= '0' && c <= '9')) {
+                return ParseNumber();
+            }
+            return Fail(Offset());
+        }
+    }
+
+    bool ParseObject(size_t depth)
+    {
+        if (depth >= CJSON_NESTING_LIMIT) {
+            return Fail(Offset());
+        }
+        Advance();
+        if (!m_handler.OnStartObject()) {
+            return false;
+        }
+        SkipWhitespace();
+        if (Peek() == '}') {
+            Advance();
+            return m_handler.OnEndObject();
+        }
+        for (;;) {
+            SkipWhitespace();
+            if (Peek() != '"') {
+                return Fail(Offset());
+            }
+            if (!ParseString(m_token) || !m_handler.OnKey(m_token.data(), m_token.length())) {
+                return false;
+            }
+            SkipWhitespace();
+            if (Peek() != ':') {
+                return Fail(Offset());
+            }
+            Advance();
+            if (!ParseValue(depth + 1)) {
+                return false;
+            }
+            SkipWhitespace();
+            const int c = Peek();
+            if (c == '}') {
+                Advance();
+                return m_handler.OnEndObject();
+            }
+            if (c != ',') {
+                return Fail(Offset());
+            }
+            Advance();
+        }
+    }
+
+    bool ParseArray(size_t depth)
+    {
+        if (depth >= CJSON_NESTING_LIMIT) {
+            return Fail(Offset());
+        }
+        Advance();
+        if (!m_handler.OnStartArray()) {
+            return false;
+        }
+        SkipWhitespace();
+        if (Peek() == ']') {
+            Advance();
+            return m_handler.OnEndArray();
+        }
+        for (;;) {
+            if (!ParseValue(depth + 1)) {
+                return false;
+            }
+            SkipWhitespace();
+            const int c = Peek();
+            if (c == ']') {
+                Advance();
+                return m_handler.OnEndArray();
+            }
+            if (c != ',') {
+                return Fail(Offset());
+            }
+            Advance();
+        }
+    }
+
+    bool ParseLiteral(const char *literal, size_t length)
+    {
+        const size_t start = Offset();
+        for (size_t i = 0; i < length; ++i) {
+            if (Peek() != static_cast<unsigned char>(literal[i])) {
+                return Fail(start);
+            }
+            Advance();
+        }
+        return true;
+    }
+
+    bool ParseNumber()
+    {
+        const size_t start = Offset();
+        m_token.clear();
+        for (int c = Peek(); (c >= '0' && c <= '9') || c == '+' || c == '-' ||
+                             c == 'e' || c == 'E' || c == '.'; c = Peek()) {
+            // strtod() expects the locale's decimal point, like in cJSON
+            m_token += (c == '.') ? m_decimalPoint : static_cast<char>(c);
+            Advance();
+        }
+        char *parsedEnd = nullptr;
+        const double value = strtod(m_token.c_str(), &parsedEnd);
+        const size_t parsed = parsedEnd - m_token.c_str();
+        if (parsed != m_token.length()) {
+            return Fail(start + parsed);
+        }
+        return m_handler.OnNumber(value);
+    }
+
+    // Parses a string (starting at its opening quote) into out as unescaped UTF-8.
+    bool ParseString(std::string &out)
+    {
+        Advance();
+        out.clear();
+        for (;;) {
+            if (m_pos == m_end && !Refill()) {
+                return Fail(Offset());
+            }
+            const char *start = m_data + m_pos;
+            const char *end = m_data + m_end;
+            const char *p = start;
+            while (p < end && *p != '"' && *p != '\\') {
+                if (*p == '\n') {
+                    ++m_lineCount;
+                    m_lineStart = m_bufferOffset + (p - m_data) + 1;
+                }
+                ++p;
+            }
+            out.append(start, p);
+            m_pos = p - m_data;
+            if (p == end) {
+                continue;
+            }
+            Advance();
+            if (*p == '"') {
+                return true;
+            }
+            const size_t escapeStart = Offset() - 1;
+            const int c = Peek();
+            switch (c) {
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case '"':
+            case '\\':
+            case '/':
+                out += static_cast<char>(c);
+                break;
+            case 'u':
+                Advance();
+                if (!ParseUnicodeEscape(out, escapeStart)) {
+                    return false;
+                }
+                continue;
+            default:
+                return Fail(escapeStart);
+            }
+            Advance();
+        }
+    }
+
+    bool ReadHex(unsigned int &code)
+    {
+        code = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            const int c = Peek();
+            code <<= 4;
+            if (c >= '0' && c <= '9') {
+                code |= (c - '0');
+            }
+            else if (c >= 'a' && c <= 'f') {
+                code |= (c - 'a' + 10);
+            }
+            else if (c >= 'A' && c <= 'F') {
+                code |= (c - 'A' + 10);
+            }
+            else {
+                return false;
+            }
+            Advance();
+        }
+        return true;
+    }
+
+    // Decodes a \uXXXX escape (and the low half of a surrogate pair), after the "\u".
+    bool ParseUnicodeEscape(std::string &out, size_t escapeStart)
+    {
+        unsigned int code{ 0 };
+        if (!ReadHex(code) || (code >= 0xDC00 && code <= 0xDFFF)) {
+            return Fail(escapeStart);
+        }
+        if (code >= 0xD800 && code <= 0xDBFF) {
+            unsigned int low{ 0 };
+            if (Peek() != '\\') {
+                return Fail(escapeStart);
+            }
+            Advance();
+            if (Peek() != 'u') {
+                return Fail(escapeStart);
+            }
+            Advance();
+            if (!ReadHex(low) || low < 0xDC00 || low > 0xDFFF) {
+                return Fail(escapeStart);
+            }
+            code = 0x10000 + (((code & 0x3FF) << 10) | (low & 0x3FF));
+        }
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        }
+        else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else if (code < 0x10000) {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else {
+            out += static_cast<char>(0xF0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        return true;
+    }
+
+    wxSimpleJSON::EventHandler &m_handler;
+    ReadFunction m_read;
+    std::vector<char> m_storage;
+    const char *m_data{ nullptr };
+    size_t m_pos{ 0 };
+    size_t m_end{ 0 };
+    bool m_eof{ false };
+    // offset of m_data[0] within the input
+    size_t m_bufferOffset{ 0 };
+    // position of the current line
+    size_t m_lineCount{ 0 };
+    size_t m_lineStart{ 0 };
+    bool m_failed{ false };
+    size_t m_errorOffset{ 0 };
+    std::string m_token;
+    const char m_decimalPoint{ *localeconv()->decimal_point };
+};
+
+bool wxSimpleJSON::EventReader::Parse(wxInputStream &stream)
+{
+    EventParser parser(m_handler, [&stream](char *buffer, size_t size)
+        {
+        stream.Read(buffer, size);
+        return stream.LastRead();
+        }, m_bufferSize);
+    return parser.Parse(m_lastError);
+}
+
+bool wxSimpleJSON::EventReader::Parse(const wxFileName &filename)
+{
+    wxFFile fp(filename.GetFullPath(), "rb");
+    if (!fp.IsOpened()) {
+        m_lastError = wxString::Format(_(L"Unable to open '%s'."), filename.GetFullPath());
+        return false;
+    }
+    EventParser parser(m_handler, [&fp](char *buffer, size_t size)
+        {
+        return fp.Read(buffer, size);
+        }, m_bufferSize);
+    return parser.Parse(m_lastError);
+}
+
+bool wxSimpleJSON::EventReader::Parse(const char *data, size_t length)
+{
+    if (data == nullptr) {
+        length = 0;
+    }
+    EventParser parser(m_handler, data, length);
+    return parser.Parse(m_lastError);
+}
+
+// wxSimpleJSON::NDJSONReader
+
+wxSimpleJSON::NDJSONReader::~NDJSONReader() {}
+
+bool wxSimpleJSON::NDJSONReader::ReadLine(const char *&line, size_t &length)
+{
+    for (;;) {
+        const char *start = m_buffer.data() + m_pos;
+        const char *newLine = static_cast<const char *>(memchr(start, '\n', m_end - m_pos));
+        if (newLine != nullptr) {
+            line = start;
+            length = newLine - start;
+            m_pos += length + 1;
+            return true;
+        }
+        if (m_eof) {
+            // the last line doesn't need to end with a newline
+            line = start;
+            length = m_end - m_pos;
+            m_pos = m_end;
+            return (length > 0);
+        }
+        // move the partial line to the front, growing the buffer for long lines
+        memmove(m_buffer.data(), start, m_end - m_pos);
+        m_end -= m_pos;
+        m_pos = 0;
+        if (m_end == m_buffer.size()) {
+            m_buffer.resize(m_buffer.size() * 2);
+        }
+        size_t count{ 0 };
+        if (m_stream != nullptr) {
+            m_stream->Read(m_buffer.data() + m_end, m_buffer.size() - m_end);
+            count = m_stream->LastRead();
+        }
+        else if (m_file.IsOpened()) {
+            count = m_file.Read(m_buffer.data() + m_end, m_buffer.size() - m_end);
+        }
+        m_eof = (count == 0);
+        m_end += count;
+    }
+}
+
+// Reads the next line that isn't blank.
+bool wxSimpleJSON::NDJSONReader::ReadRecordLine(const char *&line, size_t &length)
+{
+    do {
+        if (!ReadLine(line, length)) {
+            return false;
+        }
+        ++m_lineNumber;
+    } while (std::all_of(line, line + length,
+                         [](char c) { return static_cast<unsigned char>(c) <= 32; }));
+    return true;
+}
+
+wxSimpleJSON::Ptr_t wxSimpleJSON::NDJSONReader::CreateRecordError(const char *line, size_t length,
+                                                                  const char *parseEnd,
+                                                                  size_t lineNumber)
+{
+    if (parseEnd == nullptr || parseEnd < line || parseEnd > line + length) {
+        parseEnd = line;
+    }
+    auto record = Create(nullptr);
+    record->SetLastError(FormatParseError(lineNumber - 1, parseEnd - line, line,
+                                          parseEnd, line + length, wxConvUTF8));
+    return record;
+}
+
+bool wxSimpleJSON::NDJSONReader::Next(Ptr_t &record)
+{
+    // drop the caller's reference first, so that its memory can be reused
+    record.reset();
+
+    const char *line{ nullptr };
+    size_t length{ 0 };
+    if (!ReadRecordLine(line, length)) {
+        return false;
+    }
+
+    if (m_reuseNodes) {
+        if (m_record.get() != nullptr && m_record.unique()) {
+            m_record->ResetHandle();
+        }
+        else {
+            m_record.reset();
+        }
+        // recycle the arena, unless a node from the previous record is still in use
+        if (m_storage.get() != nullptr && m_storage.unique()) {
+            m_storage->m_arena.Reset();
+        }
+        else {
+            m_storage.reset(new DocumentStorage);
+        }
+    }
+
+    const StatisticsTimer timer(Parses, ParseNanoseconds);
+    CountStatistic(BytesParsed, length);
+    const ArenaScope scope(m_storage);
+    const char *parseEnd{ nullptr };
+    cJSON *p = ParseDocument(line, length, parseEnd);
+    if (p == nullptr) {
+        record = CreateRecordError(line, length, parseEnd, m_lineNumber);
+        return true;
+    }
+
+    if (!m_reuseNodes) {
+        record = Create(p, true);
+        return true;
+    }
+    if (m_record.get() == nullptr) {
+        m_record = Create(p, true);
+    }
+    else {
+        m_record->m_d = p;
+        m_record->m_canDelete = true;
+    }
+    m_record->m_storage = m_storage;
+    record = m_record;
+    return true;
+}
+
+size_t wxSimpleJSON::NDJSONReader::NextBatch(std::vector<Ptr_t> &records, size_t maxRecords,
+                                             unsigned int threads)
 {
-    char *b = pretty ? cJSON_Print(m_d) : cJSON_PrintUnformatted(m_d);
-    wxString s(b, conv);
-    free(b);
-    return s;
+    records.clear();
+    // the read buffer moves as it is refilled, so collect the lines first
+    std::string text;
+    std::vector<std::pair<size_t, size_t>> lines;
+    std::vector<size_t> lineNumbers;
+    const char *line{ nullptr };
+    size_t length{ 0 };
+    while (lines.size() < maxRecords && ReadRecordLine(line, length)) {
+        lines.emplace_back(text.length(), length);
+        lineNumbers.push_back(m_lineNumber);
+        text.append(line, length);
+    }
+
+    records.resize(lines.size());
+    const size_t tasks = std::min(GetThreadCount(threads), lines.size());
+    ParallelFor(tasks, [&](size_t task)
+        {
+        for (size_t i = task * lines.size() / tasks; i < (task + 1) * lines.size() / tasks; ++i) {
+            const char *begin = text.data() + lines[i].first;
+            const StatisticsTimer timer(Parses, ParseNanoseconds);
+            CountStatistic(BytesParsed, lines[i].second);
+            const char *parseEnd{ nullptr };
+            cJSON *p = ParseDocument(begin, lines[i].second, parseEnd);
+            records[i] = (p != nullptr) ? Create(p, true) :
+                CreateRecordError(begin, lines[i].second, parseEnd, lineNumbers[i]);
+        }
+        });
+    return records.size();
+}
+
+// wxSimpleJSON::NDJSONWriter
+
+bool wxSimpleJSON::NDJSONWriter::Write(const View &record)
+{
+    if (!record.IsOk() || m_failed) {
+        return false;
+    }
+    const size_t start = m_buffer.length();
+    if (!record.Write([this](const char *data, size_t length)
+            {
+            m_buffer.append(data, length);
+            return true;
+            }, false)) {
+        m_buffer.resize(start);
+        return false;
+    }
+    m_buffer += '\n';
+    return (m_buffer.length() < m_bufferSize || Flush());
+}
+
+bool wxSimpleJSON::NDJSONWriter::Flush()
+{
+    if (!m_buffer.empty() && !m_failed) {
+        m_stream.Write(m_buffer.data(), m_buffer.length());
+        m_failed = (m_stream.LastWrite() != m_buffer.length());
+    }
+    m_buffer.clear();
+    return !m_failed;
 }
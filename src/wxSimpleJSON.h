@@ -8,7 +8,17 @@
 #include <wx/dlimpexp.h>
 #include <wx/ffile.h>
 #include <wx/numformatter.h>
+#include <wx/stream.h>
 #include <vector>
+#include <string>
+#include <functional>
+#include <cstdio>
+#include <iterator>
+#include <cstddef>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+#include <limits>
 
 #ifdef JSON_CREATING_DLL
 #    define JSON_API_EXPORT WXEXPORT
@@ -20,7 +30,23 @@
 
 typedef struct cJSON cJSON;
 
-/// @brief Class for reading, parsing, and writing JSON data.
+/**
+ * @brief Class for reading, parsing, and writing JSON data.
+ * @par Threads
+ *      Documents are not synchronized. Separate documents can be used on separate
+ *      threads freely, and a document can be read from several threads at once
+ *      as long as nothing changes it (Add(), DeleteProperty(), etc.) meanwhile,
+ *      and it wasn't parsed lazily (see ParseOptions::lazy) and doesn't have a
+ *      print cache (see EnablePrintCache()), because reading those changes them.
+ *      Copies of a Ptr_t can be made and dropped on any thread, but a single Ptr_t
+ *      (like any object) must not be changed on one thread while used on another.
+ *      Handles into a document (and views) don't keep it alive, so its root must
+ *      outlive every handle on every thread.
+ * @par
+ *      To share a document between threads, Freeze() it: a FrozenNode can't be
+ *      changed, and each one (including the ones for its children) keeps the
+ *      whole document alive.
+ */
 class JSON_API_EXPORT wxSimpleJSON
 {
   protected:
@@ -28,6 +54,22 @@ class JSON_API_EXPORT wxSimpleJSON
     bool m_canDelete{ false };
     wxString m_lastError;
 
+    struct KeyIndex;
+    wxSharedPtr<KeyIndex> m_index;
+
+    struct DocumentStorage;
+    // Memory shared by every handle into a document parsed into an arena.
+    // Null for documents that use the regular heap.
+    wxSharedPtr<DocumentStorage> m_storage;
+
+    struct PrintCache;
+    // The printed text of the document's arrays and objects, shared by every
+    // handle into the document. Null unless EnablePrintCache() was called.
+    wxSharedPtr<PrintCache> m_printCache;
+
+    // A compiled document mapped into memory (see MapFile()).
+    struct MappedStorage;
+
   public:
 
     /// @brief The data values that JSON supports.
@@ -52,12 +94,489 @@ class JSON_API_EXPORT wxSimpleJSON
         /// @brief Raw data.
         IS_RAW = 128
     };
+
+    /// @brief Options controlling how JSON text is parsed.
+    struct ParseOptions
+    {
+        /**
+         * @brief Allocate the document's nodes and strings from an arena.
+         * @details By default, every node and string is a separate heap
+         *      allocation, and freeing a document frees each of them in turn.
+         *      With an arena, they are carved out of a few large blocks
+         *      owned by the document, which is faster to parse, uses less
+         *      memory and is released in one shot once the root (and every
+         *      handle into the document) is gone.
+         *      Nodes added to the document later are allocated from its arena
+         *      as well, and nodes from other documents are copied into it.
+         * @note The library owns cJSON's allocation hooks, which it installs
+         *      (with cJSON_InitHooks()) when the first arena is created. The
+         *      program must not install hooks of its own.
+         */
+        bool useArena{ false };
+        /**
+         * @brief The number of threads to parse with (0 to use all of the CPU's cores).
+         * @details A large document whose root is an array is split between
+         *      threads at its top-level elements, which are parsed concurrently
+         *      and joined back into one array. The result (and the error for
+         *      malformed text, which is always reported by the serial parser)
+         *      is the same as parsing with a single thread.
+         *      Other documents are parsed on the calling thread.
+         */
+        unsigned int threads{ 1 };
+        /**
+         * @brief Parse arrays and objects only when they are first reached.
+         * @details Loading only checks the document's structure (that brackets
+         *      match and strings are terminated) and parses its top level.
+         *      Each nested array or object is parsed, one level at a time, the
+         *      first time it is reached through a handle or view (GetProperty(),
+         *      Item(), iterating, printing, etc.), straight from the document's
+         *      text, which the document keeps. Reading a few values from a large
+         *      document then only costs a quick scan of its text.
+         *      LoadFile() hands the text it read over to the document, but text
+         *      passed to Create() or CreateFromUTF8() is copied first (see
+         *      @c borrowText).
+         *      Lazy documents always use an arena (see @c useArena), and
+         *      @c threads is ignored.
+         * @warning Nested values are fully checked only when they are parsed:
+         *      one that turns out to be malformed reads as an invalid node
+         *      (of type IS_INVALID) rather than failing the load.
+         *      And since reading a lazy document can parse it, it must not be
+         *      read from several threads at once.
+         */
+        bool lazy{ false };
+        /**
+         * @brief Have a lazy document refer to the text passed to CreateFromUTF8()
+         *      instead of keeping a copy of it.
+         * @warning The caller's text must then stay unchanged, and outlive the
+         *      document and every handle into it.
+         *      Ignored unless @c lazy is set.
+         */
+        bool borrowText{ false };
+    };
+
+    /**
+     * @brief Counters of the work done by the library (across every document and thread),
+     *      from GetStatistics().
+     * @details Counting is off until EnableStatistics() is called.
+     */
+    struct Statistics
+    {
+        /// @brief Nodes created by parsing and decoding documents, by Create() and by
+        ///     adding values (copies of other documents' nodes aren't counted).
+        uint64_t nodesCreated{ 0 };
+        /// @brief wxSimpleJSON objects allocated for handles (Ptr_t).
+        uint64_t handlesCreated{ 0 };
+        /// @brief Documents parsed (or decoded).
+        uint64_t parses{ 0 };
+        /// @brief Bytes of text (or CBOR) parsed.
+        uint64_t bytesParsed{ 0 };
+        /// @brief Time spent parsing, in nanoseconds.
+        uint64_t parseNanoseconds{ 0 };
+        /// @brief Nodes (and their contents) printed as text.
+        uint64_t prints{ 0 };
+        /// @brief Bytes of text printed.
+        uint64_t bytesPrinted{ 0 };
+        /// @brief Time spent printing, in nanoseconds.
+        uint64_t printNanoseconds{ 0 };
+        /// @brief Properties compared while searching objects for a name
+        ///     (GetProperty(), DeleteProperty(), etc.) without an index.
+        uint64_t keyScanSteps{ 0 };
+        /// @brief wxStrings converted to multibyte text (names, values and texts to parse).
+        uint64_t transcodes{ 0 };
+        /// @brief Bytes of multibyte text produced by those conversions.
+        uint64_t transcodedBytes{ 0 };
+        /// @brief Memory allocations made by cJSON and the library through cJSON's hooks
+        ///     (including those carved out of a document's arena).
+        uint64_t allocations{ 0 };
+        /// @brief Bytes requested by those allocations.
+        uint64_t allocatedBytes{ 0 };
+        /// @brief Memory released through cJSON's hooks (arena memory is released with its
+        ///     document instead, so this is less than @c allocations for arena documents).
+        uint64_t frees{ 0 };
+    };
+
+    /**
+     * @brief Declares the JSON properties of a C++ type, for To() and From().
+     * @details Specialize it (usually with the WX_SIMPLE_JSON_BIND_BEGIN() macros
+     *      at global scope) with a function that passes each field, with its property
+     *      name, to a visitor, in the order that the properties should be written:
+     * @code
+     *  template<>
+     *  struct wxSimpleJSON::Binding<Monitor>
+     *  {
+     *      template<typename Visitor, typename Value>
+     *      static void VisitFields(Visitor &visitor, Value &value)
+     *      {
+     *          visitor.Field("name", 4, value.m_name);
+     *          visitor.Field("resolutions", 11, value.m_resolutions);
+     *      }
+     *  };
+     * @endcode
+     *      The names must be UTF-8 string literals (or otherwise outlive every document
+     *      written with them). Fields can be @c bool, numbers, @c std::string (UTF-8),
+     *      wxString, bound types and @c std::vectors of those.
+     */
+    template<typename T>
+    struct Binding;
+    class BindingReader;
+    class BindingWriter;
+
     virtual ~wxSimpleJSON();
 
     /// @brief A shared wxSimpleJSON pointer.
     /// @details This is what is usually returned while traversing JSON data.
     using Ptr_t = wxSharedPtr<wxSimpleJSON>;
 
+    /// @brief Receives serialized (UTF-8) JSON text from Write().
+    /// @details Called with consecutive chunks of the output;
+    ///     return @c false to abort writing.
+    using WriteCallback = std::function<bool(const char *data, size_t length)>;
+
+    class iterator;
+
+    /**
+     * @brief Receives the events of an EventReader.
+     * @details Override the events of interest; the defaults ignore the value
+     *      and continue. Return @c false from any event to stop parsing.
+     *      Keys and strings are unescaped UTF-8 and are only valid for the
+     *      duration of the call.
+     */
+    class JSON_API_EXPORT EventHandler
+    {
+      public:
+        virtual ~EventHandler() = default;
+
+        /// @brief Called at the opening brace of an object.
+        virtual bool OnStartObject() { return true; }
+        /// @brief Called with the name of each property, before its value's events.
+        virtual bool OnKey(const char * /*key*/, size_t /*length*/) { return true; }
+        /// @brief Called at the closing brace of an object.
+        virtual bool OnEndObject() { return true; }
+        /// @brief Called at the opening bracket of an array.
+        virtual bool OnStartArray() { return true; }
+        /// @brief Called at the closing bracket of an array.
+        virtual bool OnEndArray() { return true; }
+        /// @brief Called for a string value.
+        virtual bool OnString(const char * /*value*/, size_t /*length*/) { return true; }
+        /// @brief Called for a numeric value.
+        virtual bool OnNumber(double /*value*/) { return true; }
+        /// @brief Called for @c true and @c false.
+        virtual bool OnBool(bool /*value*/) { return true; }
+        /// @brief Called for @c null.
+        virtual bool OnNull() { return true; }
+    };
+
+    class EventReader;
+    class NDJSONReader;
+    class NDJSONWriter;
+    class Path;
+    class Schema;
+    class FrozenNode;
+    class MappedNode;
+    class Document;
+
+    /**
+     * @brief A non-owning view of UTF-8 text in a document (a property name or string value).
+     * @details Points straight at the document's own bytes, so getting one
+     *      neither converts nor allocates. Comparisons are done on the raw bytes.
+     *      A view is only valid while the node it came from is; call ToString()
+     *      to keep a copy.
+     */
+    class JSON_API_EXPORT UTF8View
+    {
+      public:
+        /// @brief Constructs a null view.
+        UTF8View() = default;
+        /// @brief Constructs a view of @c length bytes at @c data.
+        UTF8View(const char *data, size_t length) : m_data(data), m_length(length) {}
+        /// @brief Constructs a view of a null-terminated string.
+        explicit UTF8View(const char *text)
+            : m_data(text), m_length(text != nullptr ? std::strlen(text) : 0) {}
+
+        /// @returns @c true if the view does not refer to any text
+        ///     (e.g., it was read from a node of another type).
+        bool IsNull() const { return (m_data == nullptr); }
+        /// @returns The first byte of the text.
+        /// @note Views into a document are null-terminated; other views may not be.
+        const char *data() const { return m_data; }
+        /// @returns The length of the text, in bytes.
+        size_t length() const { return m_length; }
+        /// @returns The length of the text, in bytes.
+        size_t size() const { return m_length; }
+        /// @returns @c true if the text is empty (or null).
+        bool empty() const { return (m_length == 0); }
+        const char *begin() const { return m_data; }
+        const char *end() const { return m_data + m_length; }
+
+        /// @returns @c true if the text is exactly the @c length bytes at @c text.
+        bool Equals(const char *text, size_t length) const
+            {
+            return (m_length == length &&
+                    (length == 0 || std::memcmp(m_data, text, length) == 0));
+            }
+        /// @returns @c true if the text is exactly @c text.
+        bool Equals(const UTF8View &text) const
+            { return Equals(text.m_data, text.m_length); }
+        /// @returns @c true if the text matches @c text, ignoring the case of ASCII letters
+        ///     (the same comparison as a case-insensitive GetProperty()).
+        bool EqualsNoCase(const char *text, size_t length) const;
+        /// @returns @c true if the text matches @c text, ignoring the case of ASCII letters.
+        bool EqualsNoCase(const UTF8View &text) const
+            { return EqualsNoCase(text.m_data, text.m_length); }
+
+        bool operator==(const UTF8View &that) const { return Equals(that); }
+        bool operator!=(const UTF8View &that) const { return !Equals(that); }
+        /// @brief Orders views by their bytes (like @c strcmp()).
+        bool operator<(const UTF8View &that) const;
+
+        /// @returns A copy of the text as a wxString.
+        wxString ToString() const
+            { return (m_data != nullptr) ? wxString::FromUTF8(m_data, m_length) : wxString(); }
+        /// @returns A copy of the text as a std::string.
+        std::string ToStdString() const
+            { return (m_data != nullptr) ? std::string(m_data, m_length) : std::string(); }
+
+      private:
+        const char *m_data{ nullptr };
+        size_t m_length{ 0 };
+    };
+
+    /**
+     * @brief A lightweight, non-owning handle to a node.
+     * @details A View is a plain pointer-sized value that is passed by value
+     *      and exposes the same read API as wxSimpleJSON. Traversing through
+     *      views (GetProperty(), Item(), iterating) never allocates, which makes
+     *      them the preferred way to read deep or large documents.
+     *      A view does not keep its document alive; the owning root
+     *      wxSimpleJSON::Ptr_t must outlive every view into it.
+     */
+    class JSON_API_EXPORT View
+    {
+      public:
+        class iterator;
+
+        /// @brief Constructs a null view.
+        View() = default;
+
+        /// @returns @c true if the view does not refer to a node.
+        bool IsNull() const { return (m_d == nullptr); }
+        /// @returns @c true if the view refers to a node.
+        bool IsOk() const { return (m_d != nullptr); }
+
+        /// @returns The node's value type.
+        /// @details The type is read (without cJSON's flags) when the view is made,
+        ///     so this and the @c IsValue...() functions below are inline comparisons.
+        wxSimpleJSON::JSONType GetType() const { return m_type; }
+
+        /// @returns @c true if the node's value type is a string.
+        bool IsValueString() const
+            { return GetType() == wxSimpleJSON::JSONType::IS_STRING; }
+        /// @returns @c true if the node's value type is a number.
+        bool IsValueNumber() const
+            { return GetType() == wxSimpleJSON::JSONType::IS_NUMBER; }
+        /// @returns @c true if the node's value type is null.
+        bool IsValueNull() const
+            { return GetType() == wxSimpleJSON::JSONType::IS_NULL; }
+        /// @returns @c true if the node's value type is an array.
+        bool IsValueArray() const
+            { return GetType() == wxSimpleJSON::JSONType::IS_ARRAY; }
+        /// @returns @c true if the node's value type is an object.
+        bool IsValueObject() const
+            { return GetType() == wxSimpleJSON::JSONType::IS_OBJECT; }
+        /// @returns @c true if the node's value type is a boolean.
+        bool IsValueBoolean() const
+            {
+            return (GetType() & (wxSimpleJSON::JSONType::IS_TRUE |
+                                 wxSimpleJSON::JSONType::IS_FALSE)) != 0;
+            }
+
+        /**
+         * @brief Calls the function of @c visitor for the node's type, switching on it once.
+         * @details The visitor needs all of these functions, returning the same type:
+         * @code
+         *  R OnNull();
+         *  R OnBool(bool value);
+         *  R OnNumber(double value);
+         *  R OnString(wxSimpleJSON::UTF8View value);
+         *  R OnArray(wxSimpleJSON::View array);   // e.g., visits each item in turn
+         *  R OnObject(wxSimpleJSON::View object);
+         *  R OnRaw(wxSimpleJSON::UTF8View text);
+         *  R OnInvalid();                         // also called for a null view
+         * @endcode
+         * @returns What the visitor's function returned.
+         */
+        template<typename Visitor>
+        auto Visit(Visitor &&visitor) const -> decltype(visitor.OnNull())
+            {
+            switch (m_type)
+                {
+                case wxSimpleJSON::JSONType::IS_NULL:
+                    return visitor.OnNull();
+                case wxSimpleJSON::JSONType::IS_FALSE:
+                    return visitor.OnBool(false);
+                case wxSimpleJSON::JSONType::IS_TRUE:
+                    return visitor.OnBool(true);
+                case wxSimpleJSON::JSONType::IS_NUMBER:
+                    return visitor.OnNumber(GetValueNumber());
+                case wxSimpleJSON::JSONType::IS_STRING:
+                    return visitor.OnString(GetText());
+                case wxSimpleJSON::JSONType::IS_ARRAY:
+                    return visitor.OnArray(*this);
+                case wxSimpleJSON::JSONType::IS_OBJECT:
+                    return visitor.OnObject(*this);
+                case wxSimpleJSON::JSONType::IS_RAW:
+                    return visitor.OnRaw(GetText());
+                default:
+                    return visitor.OnInvalid();
+                }
+            }
+
+        /// @brief Checks the node against a schema (see wxSimpleJSON::Validate()).
+        bool Validate(const Schema &schema, wxString *error = nullptr) const;
+
+        /// @returns The number of items in the array, or 0 if this is not an array.
+        size_t ArraySize() const;
+        /// @returns The array item at @c index, or a null view.
+        View Item(size_t index) const;
+        /// @returns An iterator to the first child of an array or object.
+        iterator begin() const;
+        /// @returns The past-the-end iterator for this node's children.
+        iterator end() const;
+
+        /// @returns The property called @c name, or a null view.
+        View GetProperty(const wxString &name, bool caseSensitive = false) const;
+        /// @returns The property called @c name (UTF-8 encoded), or a null view.
+        /// @note Unlike the wxString overload, this does not convert the name.
+        View GetProperty(const char *name, bool caseSensitive = false) const;
+        /// @returns The property called @c name, or a null view.
+        /// @note The name does not need to be null-terminated.
+        View GetProperty(const UTF8View &name, bool caseSensitive = false) const;
+        /// @returns @c true if the node has a property called @c name.
+        bool HasProperty(const wxString &name, bool caseSensitive = false) const;
+        /// @returns The node that a JSON Pointer (e.g., @c "/a/b/2") refers to, or a null view.
+        View At(const wxString &pointer) const;
+        /// @returns The node that a UTF-8 encoded JSON Pointer refers to, or a null view.
+        View At(const char *pointer) const;
+        /// @returns The node that a compiled path refers to, or a null view.
+        View At(const Path &path) const;
+        /// @returns The names of the object's properties.
+        wxArrayString GetObjectKeys(const wxMBConv &conv = wxConvUTF8) const;
+        /// @returns The names of the object's properties, without copying them.
+        std::vector<UTF8View> GetObjectKeysUTF8() const;
+        /// @returns The node's name if it is an object's property, or a null view.
+        UTF8View GetNameUTF8() const;
+
+        /// @returns The node's string value, or @c defaultValue.
+        wxString GetValueString(const wxString &defaultValue = wxEmptyString,
+                                const wxMBConv &conv = wxConvUTF8) const;
+        /// @returns The node's string value without copying it,
+        ///     or a null view if the node is not a string.
+        UTF8View GetValueStringUTF8() const;
+        /// @returns The node's boolean value, or @c defaultValue.
+        bool GetValueBool(bool defaultValue = false) const;
+        /// @returns The node's numeric value, or @c defaultValue.
+        double GetValueNumber(double defaultValue = -1) const;
+        /// @returns The array's values as booleans.
+        std::vector<bool> GetValueArrayBool(bool defaultValue = false) const;
+        /// @returns The array's values as strings.
+        wxArrayString GetValueArrayString(const wxMBConv &conv = wxConvUTF8) const;
+        /// @returns The array's values as a vector of strings.
+        std::vector<wxString> GetValueStringVector(const wxMBConv &conv = wxConvUTF8) const;
+        /// @returns The array's values as views of their text
+        ///     (null views for items that are not strings).
+        std::vector<UTF8View> GetValueArrayStringUTF8() const;
+        /// @returns The array's values as numbers.
+        std::vector<double> GetValueArrayNumber(double defaultValue = -1) const;
+        /// @brief Copies the array's numbers into @c values (see wxSimpleJSON::CopyArrayTo()).
+        size_t CopyArrayTo(double *values, size_t count,
+                           std::vector<size_t> *mismatches = nullptr) const;
+        /// @overload
+        size_t CopyArrayTo(float *values, size_t count,
+                           std::vector<size_t> *mismatches = nullptr) const;
+        /// @overload
+        size_t CopyArrayTo(int64_t *values, size_t count,
+                           std::vector<size_t> *mismatches = nullptr) const;
+        /// @brief Sizes @c values to the array and copies its numbers into it.
+        size_t CopyArrayTo(std::vector<double> &values,
+                           std::vector<size_t> *mismatches = nullptr) const;
+        /// @overload
+        size_t CopyArrayTo(std::vector<float> &values,
+                           std::vector<size_t> *mismatches = nullptr) const;
+        /// @overload
+        size_t CopyArrayTo(std::vector<int64_t> &values,
+                           std::vector<size_t> *mismatches = nullptr) const;
+        /// @brief Copies a numeric property of each of the array's objects into @c values
+        ///     (see wxSimpleJSON::CopyArrayPropertyTo()).
+        size_t CopyArrayPropertyTo(const wxString &name, double *values, size_t count,
+                                   std::vector<size_t> *mismatches = nullptr,
+                                   bool caseSensitive = false) const;
+        /// @overload
+        size_t CopyArrayPropertyTo(const wxString &name, float *values, size_t count,
+                                   std::vector<size_t> *mismatches = nullptr,
+                                   bool caseSensitive = false) const;
+        /// @overload
+        size_t CopyArrayPropertyTo(const wxString &name, int64_t *values, size_t count,
+                                   std::vector<size_t> *mismatches = nullptr,
+                                   bool caseSensitive = false) const;
+        /// @overload
+        size_t CopyArrayPropertyTo(const wxString &name, std::vector<double> &values,
+                                   std::vector<size_t> *mismatches = nullptr,
+                                   bool caseSensitive = false) const;
+        /// @overload
+        size_t CopyArrayPropertyTo(const wxString &name, std::vector<float> &values,
+                                   std::vector<size_t> *mismatches = nullptr,
+                                   bool caseSensitive = false) const;
+        /// @overload
+        size_t CopyArrayPropertyTo(const wxString &name, std::vector<int64_t> &values,
+                                   std::vector<size_t> *mismatches = nullptr,
+                                   bool caseSensitive = false) const;
+        /// @returns The array's items as views.
+        std::vector<View> GetValueArrayObject() const;
+
+        /// @returns The node as JSON text.
+        wxString Print(bool pretty = true, const wxMBConv &conv = wxConvUTF8) const;
+        /// @returns The node as UTF-8 encoded JSON text.
+        std::string PrintUTF8(bool pretty = true) const;
+        /// @brief Replaces @c text with the node as UTF-8 encoded JSON text,
+        ///     reusing the string's memory.
+        /// @returns @c false (leaving @c text empty) if the node is invalid.
+        bool PrintUTF8(std::string &text, bool pretty = true) const;
+        /// @brief Serializes the node to a callback.
+        bool Write(const WriteCallback &sink, bool pretty = true) const;
+        /// @brief Serializes the node to a stream.
+        bool Write(wxOutputStream &stream, bool pretty = true) const;
+        /// @brief Serializes the node to a file handle.
+        bool Write(FILE *fp, bool pretty = true) const;
+        /// @brief Encodes the node as CBOR, passing the bytes to a callback.
+        bool WriteBinary(const WriteCallback &sink) const;
+        /// @brief Replaces @c data with the node encoded as CBOR, reusing the string's memory.
+        /// @returns @c false (leaving @c data empty) if the node is invalid.
+        bool WriteBinary(std::string &data) const;
+        /// @brief Writes the node as a compiled document (see wxSimpleJSON::WriteCompiled()).
+        bool WriteCompiled(const WriteCallback &sink) const;
+
+        /// @brief Reads this object into a bound type (see wxSimpleJSON::To()).
+        template<typename T>
+        bool To(T &value) const;
+        /// @overload
+        template<typename T>
+        T To() const;
+
+        bool operator==(const View &that) const { return m_d == that.m_d; }
+        bool operator!=(const View &that) const { return m_d != that.m_d; }
+
+      private:
+        friend class wxSimpleJSON;
+        friend class Schema;
+        // parses the node first if it belongs to a lazy document and hasn't been yet
+        explicit View(cJSON *node);
+        // the text of a string or raw node
+        UTF8View GetText() const;
+
+        cJSON *m_d{ nullptr };
+        wxSimpleJSON::JSONType m_type{ wxSimpleJSON::JSONType::IS_INVALID };
+    };
+
   private:
     // Constructor is private. The way to create an object is by using the
     // Create() or LoadFile() methods.
@@ -67,6 +586,93 @@ class JSON_API_EXPORT wxSimpleJSON
      */
     static void Destroy(wxSimpleJSON *obj);
     static wxSimpleJSON::Ptr_t Create(cJSON *p, bool canDelete = false);
+    /**
+     * @brief Parses a buffer of encoded JSON text.
+     * @param data The encoded text (does not need to be null terminated).
+     * @param length The number of bytes in @c data.
+     * @param isRoot @c true if the returned node owns the parsed tree.
+     * @param conv The encoding of @c data, used for error messages.
+     */
+    static wxSimpleJSON::Ptr_t Parse(const char *data, size_t length, bool isRoot,
+                                     const wxMBConv &conv, const ParseOptions &options);
+    /// @brief Parses a document lazily (see ParseOptions::lazy) from @c text, which the
+    ///     document keeps, or from the caller's @c data if that isn't null.
+    static wxSimpleJSON::Ptr_t ParseLazy(const wxCharBuffer &text, const char *data, size_t length,
+                                         const wxMBConv &conv, const ParseOptions &options);
+    /// @brief Wraps a node from this node's document (e.g., one of its children).
+    wxSimpleJSON::Ptr_t CreateChild(cJSON *p) const;
+    /// @brief Returns @c obj's node, copying it first if it belongs to a
+    ///     different arena than this document.
+    cJSON *AdoptNode(wxSimpleJSON &obj) const;
+    /// @brief Detaches this handle from its node and document (along with their
+    ///     index, print cache and last error), so that it can be reused for another one.
+    void ResetHandle();
+
+    /// @brief Adds an item to this object, taking ownership of it.
+    /// @param name The property name.
+    /// @param item The item to add.
+    /// @param replace @c true to first remove an existing property with the same name.
+    /// @param deleteOnFailure @c true to delete @c item if it could not be added.
+    /// @return @c true if the item was added.
+    bool AddItem(const wxString &name, cJSON *item, bool replace,
+                 bool deleteOnFailure = true);
+    /// @brief Appends an item to this array, taking ownership of it.
+    /// @param item The item to add.
+    /// @param deleteOnFailure @c true to delete @c item if it could not be added.
+    /// @return @c true if the item was added.
+    bool ArrayAddItem(cJSON *item, bool deleteOnFailure = true);
+
+    /// @brief Builds a new array's items in a single pass, for the bulk Add() functions.
+    /// @details Nodes are allocated from the owner's document (its arena, if any)
+    ///     for as long as the builder exists.
+    class JSON_API_EXPORT ArrayBuilder
+    {
+      public:
+        explicit ArrayBuilder(const wxSimpleJSON &owner);
+        ArrayBuilder(const ArrayBuilder&) = delete;
+        ArrayBuilder& operator=(const ArrayBuilder&) = delete;
+        ~ArrayBuilder();
+
+        void Append(bool value);
+        void Append(double value);
+        template<typename T>
+        typename std::enable_if<std::is_arithmetic<T>::value &&
+                                !std::is_same<T, bool>::value>::type
+        Append(T value)
+            { Append(static_cast<double>(value)); }
+        /// @brief Appends a UTF-8 encoded string.
+        void Append(const char *value);
+        void Append(const std::string &value) { Append(value.c_str()); }
+        void Append(const wxString &value, const wxMBConv &conv = wxConvUTF8);
+
+        /// @returns The array, which the caller now owns.
+        cJSON *Release();
+
+      private:
+        void AppendItem(cJSON *item);
+
+        const wxSimpleJSON &m_owner;
+        // the arena that was in use before the builder's (restored by the destructor)
+        void *m_previousArena{ nullptr };
+        cJSON *m_array{ nullptr };
+        cJSON *m_tail{ nullptr };
+    };
+
+    /// @brief Appends a built array to this array.
+    wxSimpleJSON &ArrayAddBuilt(ArrayBuilder &builder);
+    /// @brief Adds a built array as a property, replacing one with the same name.
+    wxSimpleJSON &AddBuilt(const wxString &name, ArrayBuilder &builder);
+
+    /// @returns This handle's property index (if any), rebuilt if it is stale.
+    KeyIndex *GetIndex() const;
+    /// @returns The property called @c name (UTF-8 encoded), using the index if available.
+    cJSON *FindProperty(const char *name, bool caseSensitive) const;
+    /// @brief Removes and deletes the property called @c name (UTF-8 encoded).
+    bool RemoveProperty(const char *name, bool caseSensitive);
+    /// @brief Tells the print cache (if any) that this node has changed.
+    void MarkChanged();
+    /// @brief Deletes an item that was detached from this node.
+    void DeleteDetached(cJSON *item);
 
     /// @brief Sets the error message if parser or create fails.
     /// @param error The error message.
@@ -94,25 +700,171 @@ class JSON_API_EXPORT wxSimpleJSON
     static wxSimpleJSON::Ptr_t Create(const wxString &buffer, bool isRoot = false,
                                       const wxMBConv &conv = wxConvUTF8);
 
+    /**
+     * @brief Parse UTF-8 encoded JSON data and return a wxSimpleJSON object.
+     * @details This is the fastest way to parse data that is already
+     *      UTF-8 encoded, as it is handed to the parser as-is without
+     *      converting it to (and back from) a wxString.
+     * @param data The UTF-8 encoded JSON data (does not need to be null terminated).
+     * @param length The number of bytes in @c data.
+     * @param isRoot @c true when creating the top-level item (the root item of the JSON).
+     * @note Check returned the object by calling IsNull() or IsOk().
+     * @return A wxSimpleJSON object.
+     */
+    static wxSimpleJSON::Ptr_t CreateFromUTF8(const char *data, size_t length,
+                                              bool isRoot = false);
+
+    /**
+     * @brief Parse and return a (root) wxSimpleJSON object.
+     * @param buffer A string buffer of JSON data.
+     * @param options How to parse the data.
+     * @param conv The (optional) encoding to read the text with.
+     * @note Check returned the object by calling IsNull() or IsOk().
+     * @return A wxSimpleJSON object.
+     */
+    static wxSimpleJSON::Ptr_t Create(const wxString &buffer, const ParseOptions &options,
+                                      const wxMBConv &conv = wxConvUTF8);
+
+    /**
+     * @brief Parse UTF-8 encoded JSON data and return a (root) wxSimpleJSON object.
+     * @param data The UTF-8 encoded JSON data (does not need to be null terminated).
+     * @param length The number of bytes in @c data.
+     * @param options How to parse the data.
+     * @note Check returned the object by calling IsNull() or IsOk().
+     * @return A wxSimpleJSON object.
+     */
+    static wxSimpleJSON::Ptr_t CreateFromUTF8(const char *data, size_t length,
+                                              const ParseOptions &options);
+
     /**
      * @brief Reads JSON content from a file, parses it, and returns a
             wxSimpleJSON object that can be traversed.
      * @param filename The file path of the JSON file to load.
      * @param conv The (optional) encoding to read the file with.
+     * @note When @c conv is UTF-8 (the default), the file's bytes are read
+     *      into a single buffer and parsed directly, without being
+     *      transcoded into a wxString first.
+     * @note Check returned the object by calling IsNull() or IsOk().
+     * @return A wxSimpleJSON object.
+     */
+    static wxSimpleJSON::Ptr_t LoadFile(const wxFileName &filename,
+                                        const wxMBConv &conv = wxConvUTF8);
+
+    /**
+     * @brief Reads JSON content from a file and parses it using
+            the given options.
+     * @param filename The file path of the JSON file to load.
+     * @param options How to parse the file.
+     * @param conv The (optional) encoding to read the file with.
      * @note Check returned the object by calling IsNull() or IsOk().
      * @return A wxSimpleJSON object.
      */
     static wxSimpleJSON::Ptr_t LoadFile(const wxFileName &filename,
+                                        const ParseOptions &options,
                                         const wxMBConv &conv = wxConvUTF8);
 
+    /**
+     * @brief Decodes CBOR data (e.g., from WriteBinary()) and returns a (root) wxSimpleJSON object.
+     * @details Besides what WriteBinary() writes, integers, floats (including
+     *      half-precision ones), text strings, arrays and maps of any size and
+     *      length encoding are read, as well as @c undefined (read as null).
+     *      Other tags than embedded JSON are skipped (leaving the tagged value).
+     *      Byte strings, map keys that are not text, NaN, infinities and other
+     *      simple values have no JSON equivalent and are reported as errors.
+     * @param data The encoded data.
+     * @param length The number of bytes in @c data.
+     * @note Check returned the object by calling IsNull() or IsOk(); if the data
+     *      can't be decoded, GetLastError() says where.
+     * @return A wxSimpleJSON object.
+     */
+    static wxSimpleJSON::Ptr_t CreateFromBinary(const void *data, size_t length);
+    /// @overload
+    /// @param options How to store the document (only @c useArena applies).
+    static wxSimpleJSON::Ptr_t CreateFromBinary(const void *data, size_t length,
+                                                const ParseOptions &options);
+
+    /**
+     * @brief Creates a (root) object from a value of a bound type (see Binding).
+     * @details The properties are added in the binding's order, straight from its
+     *      names, without converting them, searching for duplicates or creating a
+     *      wxSimpleJSON::Ptr_t for any of them. For example:
+     * @code
+     *  Monitor monitor{ "Awesome 4K", { { 1280, 720 }, { 3840, 2160 } } };
+     *  wxSimpleJSON::From(monitor)->Save(wxFileName(L"c:/users/stefano/monitor.json"));
+     * @endcode
+     * @param value The value to write.
+     * @return A wxSimpleJSON object.
+     */
+    template<typename T>
+    static wxSimpleJSON::Ptr_t From(const T &value);
+
+    /**
+     * @brief Reads a CBOR encoded file (e.g., from SaveBinary()) and returns a (root)
+     *      wxSimpleJSON object.
+     * @param filename The file to load.
+     * @note Check returned the object by calling IsNull() or IsOk().
+     * @return A wxSimpleJSON object.
+     */
+    static wxSimpleJSON::Ptr_t LoadBinary(const wxFileName &filename);
+    /// @overload
+    /// @param options How to store the document (only @c useArena applies).
+    static wxSimpleJSON::Ptr_t LoadBinary(const wxFileName &filename,
+                                          const ParseOptions &options);
+
+    /**
+     * @brief Maps a compiled document (from SaveCompiled()) into memory, read-only.
+     * @details Nothing is parsed or allocated per node: the file's pages are
+     *      mapped as they are (and shared with every other process mapping the
+     *      same file), and nodes are read straight from them, so mapping even a
+     *      very large document takes constant time.
+     *      On platforms without memory mapping, the file is read into memory instead.
+     * @param filename The compiled file to map.
+     * @return A handle to the document's root, which keeps the mapping alive,
+     *      or a null handle if the file can't be opened or isn't a compiled
+     *      document (from this version of the format, on a machine of the same byte order).
+     */
+    static MappedNode MapFile(const wxFileName &filename);
+
+    /**
+     * @brief Turns counting of the library's work (see Statistics) on or off.
+     * @details Counting is off by default, when it costs a single (relaxed)
+     *      atomic load at each place that counts. When on, each thread counts
+     *      into counters of its own, which GetStatistics() adds up, so threads
+     *      don't contend for them; timing parses and prints also reads the clock
+     *      twice for each.
+     *      cJSON's allocations are counted through its allocation hooks, which
+     *      turning counting on installs (see ParseOptions::useArena).
+     * @param enable @c true to count, @c false to stop (the counts are kept).
+     */
+    static void EnableStatistics(bool enable = true);
+    /// @returns @c true if the library's work is being counted.
+    static bool IsStatisticsEnabled();
+    /// @returns A snapshot of the counts since the last ResetStatistics()
+    ///     (or the start of the program). Safe to call from any thread at any time.
+    static Statistics GetStatistics();
+    /// @brief Starts counting from zero again.
+    static void ResetStatistics();
+
     /**
      * @brief Saves the content of this object to a file.
      * @param filename The file path of the JSON file to load.
      * @param conv The (optional) encoding to save the file with.
+     * @note When @c conv is UTF-8 (the default), the content is streamed
+     *      to the file without building the whole text in memory.
      * @return @c true if the file save succeeded; @c false otherwise.
      */
     bool Save(const wxFileName &filename, const wxMBConv &conv = wxConvUTF8);
 
+    /**
+     * @brief Returns how much memory the document takes.
+     * @details For a document in an arena (see ParseOptions), this is the memory
+     *      the arena has reserved (and, for a lazy document, the copy of its text),
+     *      which belongs to the whole document, whichever of its nodes it is called on.
+     *      Otherwise, it is the memory allocated for this node and everything in it.
+     * @return The number of bytes (not counting the allocator's own overhead).
+     */
+    size_t GetMemoryUsage() const;
+
     /**
      * @brief Is this object/node null?
      * @return @c true if the object is null.
@@ -125,6 +877,43 @@ class JSON_API_EXPORT wxSimpleJSON
      */
     inline bool IsOk() const { return (m_d != nullptr); }
 
+    /**
+     * @brief Returns a non-owning view of this node.
+     * @details Use the view for read-only traversal that should not
+     *      allocate. This object (or its root) must outlive the view.
+     * @return A view of this node.
+     */
+    View GetView() const { return View(m_d); }
+
+    /**
+     * @brief Reads this object into a value of a bound type (see Binding).
+     * @details The object's properties are walked once, each one being matched
+     *      with the field of the same (case-sensitive) name, instead of searching
+     *      the object for each field. Fields without a property keep their values,
+     *      and so do fields whose property has the wrong type (or a number that
+     *      doesn't fit an integer field). For example:
+     * @code
+     *  const auto monitor = wxSimpleJSON::LoadFile(wxFileName(L"c:/users/stefano/monitor.json"))->To<Monitor>();
+     * @endcode
+     * @param[in,out] value The value to read into.
+     * @return @c false if this is not an object or a property couldn't be read.
+     */
+    template<typename T>
+    bool To(T &value) const;
+    /// @returns A value-initialized @c T, read from this object.
+    template<typename T>
+    T To() const;
+
+    /**
+     * @brief Returns a read-only copy of this node that can be shared between threads.
+     * @details The node (and everything in it) is copied into a new document,
+     *      allocated from a single arena, which is safe to read from any number
+     *      of threads at once and is freed once the last handle into it is gone.
+     *      Changes made to this node afterwards don't affect the copy.
+     * @return The frozen copy, or a null handle if this node is invalid.
+     */
+    FrozenNode Freeze() const;
+
     /// @brief Returns the last error from when the node node was created/parsed.
     /// @details Will be empty if there weren't any errors.
     const wxString& GetLastError() const
@@ -137,6 +926,43 @@ class JSON_API_EXPORT wxSimpleJSON
     wxSimpleJSON &ArrayAdd(bool value);
     wxSimpleJSON &ArrayAdd(const wxArrayString &arr, const wxMBConv &conv = wxConvUTF8);
 
+    /**
+     * @brief Appends an array of numbers to this array.
+     * @details Like the other bulk functions, the new array's items are built
+     *      in one linear pass, without creating a wxSimpleJSON::Ptr_t for each one.
+     * @param values The numbers.
+     * @param count The number of values.
+     * @return A self reference to the node.
+     */
+    wxSimpleJSON &ArrayAdd(const double *values, size_t count);
+    /// @brief Appends an array of numbers to this array.
+    wxSimpleJSON &ArrayAdd(const std::vector<double> &values)
+        { return ArrayAdd(values.data(), values.size()); }
+    /// @brief Appends an array of booleans to this array.
+    wxSimpleJSON &ArrayAdd(const std::vector<bool> &values);
+    /// @brief Appends an array of (UTF-8 encoded) strings to this array.
+    wxSimpleJSON &ArrayAdd(const std::vector<std::string> &values);
+    /**
+     * @brief Appends an array built from a range of values to this array.
+     * @details The values can be numbers, booleans, UTF-8 encoded strings
+     *      (@c std::string or <tt>const char*</tt>) or wxStrings. For example:
+     * @code
+     *  std::list<int> counts{ 1, 2, 3 };
+     *  json->ArrayAddRange(counts.cbegin(), counts.cend());
+     * @endcode
+     * @param first The first value.
+     * @param last The end of the range.
+     * @return A self reference to the node.
+     */
+    template<typename InputIt>
+    wxSimpleJSON &ArrayAddRange(InputIt first, InputIt last)
+        {
+        ArrayBuilder builder(*this);
+        for (; first != last; ++first)
+            { builder.Append(*first); }
+        return ArrayAddBuilt(builder);
+        }
+
     /**
      * @brief Returns the array size.
      * @return The number of items in the array, or 0 if this object
@@ -150,6 +976,21 @@ class JSON_API_EXPORT wxSimpleJSON
      */
     wxSimpleJSON::Ptr_t Item(size_t index) const;
 
+    /**
+     * @brief Returns an iterator to the first child of an array or object.
+     * @details Iterating visits each child once, in document order, without
+     *      allocating a wxSimpleJSON::Ptr_t per step. For example:
+     * @code
+     *  for (const auto& item : *json->GetProperty("resolutions"))
+     *      { const auto width = item.GetProperty("width")->GetValueNumber(); }
+     * @endcode
+     * @return An iterator to the first child, or end() if this node
+     *      is not an array or object (or is empty).
+     */
+    iterator begin() const;
+    /// @returns The past-the-end iterator for this node's children.
+    iterator end() const;
+
     // Object manipulation
     /**
      * @brief Adds a property to the node with another node's content.
@@ -208,6 +1049,91 @@ class JSON_API_EXPORT wxSimpleJSON
      */
     wxSimpleJSON &Add(const wxString &name, const wxArrayString &arr,
                       const wxMBConv &conv = wxConvUTF8);
+    /**
+     * @brief Adds a property to the node with an array of numbers as its value.
+     * @details The array's items are built in one linear pass, without
+     *      creating a wxSimpleJSON::Ptr_t for each one.
+     * @param name The name of the node to add.
+     * @param values The numbers.
+     * @param count The number of values.
+     * @note If a property with the same name already exists, it will be
+     *      replaced with this one.
+     * @return A self reference to the node.
+     */
+    wxSimpleJSON &Add(const wxString &name, const double *values, size_t count);
+    /// @brief Adds a property to the node with an array of numbers as its value.
+    wxSimpleJSON &Add(const wxString &name, const std::vector<double> &values)
+        { return Add(name, values.data(), values.size()); }
+    /// @brief Adds a property to the node with an array of booleans as its value.
+    wxSimpleJSON &Add(const wxString &name, const std::vector<bool> &values);
+    /// @brief Adds a property to the node with an array of (UTF-8 encoded) strings as its value.
+    wxSimpleJSON &Add(const wxString &name, const std::vector<std::string> &values);
+    /**
+     * @brief Adds a property to the node with an array built from a range of values.
+     * @param name The name of the node to add.
+     * @param first The first value (see ArrayAddRange() for the supported types).
+     * @param last The end of the range.
+     * @note If a property with the same name already exists, it will be
+     *      replaced with this one.
+     * @return A self reference to the node.
+     */
+    template<typename InputIt>
+    wxSimpleJSON &AddRange(const wxString &name, InputIt first, InputIt last)
+        {
+        ArrayBuilder builder(*this);
+        for (; first != last; ++first)
+            { builder.Append(*first); }
+        return AddBuilt(name, builder);
+        }
+
+    /**
+     * @brief Adds a property to the node with another node's content,
+     *      without checking for an existing property with the same name.
+     * @details The Add() functions first search for (and remove) a property
+     *      with the same name, which makes building large objects quadratic.
+     *      The AddUnique() functions append in constant time instead, so use
+     *      them when the caller guarantees that the names are unique
+     *      (e.g., when building a new object from a map).
+     * @param name The name of the node to add.
+     * @param obj The other node (along with its properties and values) to add.
+     * @warning If a property with the same name already exists, the object
+     *      will end up with duplicate keys.
+     * @return A self reference to the node.
+     */
+    wxSimpleJSON &AddUnique(const wxString &name, wxSimpleJSON::Ptr_t obj);
+    /**
+     * @brief Adds a string property without checking for an existing one.
+     * @param name The name of the node to add.
+     * @param value The string value to assign to the property.
+     * @param conv The (optional) encoding to use for the string.
+     * @sa AddUnique(const wxString&, wxSimpleJSON::Ptr_t)
+     * @return A self reference to the node.
+     */
+    wxSimpleJSON &AddUnique(const wxString &name, const wxString &value,
+                            const wxMBConv &conv = wxConvUTF8);
+    /**
+     * @brief Adds a numeric property without checking for an existing one.
+     * @param name The name of the node to add.
+     * @param value The numeric value to assign to the property.
+     * @sa AddUnique(const wxString&, wxSimpleJSON::Ptr_t)
+     * @return A self reference to the node.
+     */
+    wxSimpleJSON &AddUnique(const wxString &name, double value);
+    /**
+     * @brief Adds a boolean property without checking for an existing one.
+     * @param name The name of the node to add.
+     * @param value The value to assign to the property.
+     * @sa AddUnique(const wxString&, wxSimpleJSON::Ptr_t)
+     * @return A self reference to the node.
+     */
+    wxSimpleJSON &AddUnique(const wxString &name, bool value);
+    /**
+     * @brief Adds a null property without checking for an existing one.
+     * @param name The name of the node to add.
+     * @sa AddUnique(const wxString&, wxSimpleJSON::Ptr_t)
+     * @return A self reference to the node.
+     */
+    wxSimpleJSON &AddNullUnique(const wxString &name);
 
     /**
      * @brief Return the node's value as a string
@@ -222,6 +1148,15 @@ class JSON_API_EXPORT wxSimpleJSON
     wxString GetValueString(const wxString &defaultValue = wxEmptyString,
                             const wxMBConv &conv = wxConvUTF8) const;
 
+    /**
+     * @brief Returns the node's string value as a view of the document's UTF-8 text
+            (if its type is JSONType::IS_STRING).
+     * @details Unlike GetValueString(), this neither converts nor copies the text.
+     * @return The value, or a null view if the node is not a string.
+     * @note The view is only valid while this node is part of the document.
+     */
+    UTF8View GetValueStringUTF8() const;
+
     /**
      * @brief Return the node's value as a boolean
             (if its type is JSONType::IS_FALSE or JSONType::IS_TRUE).
@@ -262,6 +1197,15 @@ class JSON_API_EXPORT wxSimpleJSON
      *      you are calling the correct @c GetValue___() function.
      */
     std::vector<wxString> GetValueStringVector(const wxMBConv& conv = wxConvUTF8) const;
+
+    /**
+     * @brief Returns the node's values as views of their UTF-8 text
+            (if its type is JSONType::IS_ARRAY).
+     * @return The values, with null views for items that are not strings.
+     * @note The views are only valid while the items are part of the document.
+     */
+    std::vector<UTF8View> GetValueArrayStringUTF8() const;
+
     /**
      * @brief Returns the node's values as an array of nodes.
             (if its type is JSONType::IS_ARRAY).
@@ -291,19 +1235,105 @@ class JSON_API_EXPORT wxSimpleJSON
      */
     std::vector<double> GetValueArrayNumber(double defaultValue = -1) const;
 
+    /**
+     * @brief Copies the array's numbers into a caller-provided buffer
+            (if its type is JSONType::IS_ARRAY).
+     * @details Unlike GetValueArrayNumber(), items that are not numbers
+     *      (or, for integers and floats, whose value does not fit in the type
+     *      or, for integers, is not a whole number) are not replaced with
+     *      a default value: their slot is left unchanged and their index is
+     *      reported in @c mismatches.
+     * @param values The buffer to write to.
+     * @param count The number of values that @c values can hold. Items after
+     *      the first @c count are ignored.
+     * @param[out] mismatches If not null, receives the indices of the items
+     *      that could not be read.
+     * @return The number of items read (the array's size, up to @c count),
+     *      or 0 if this is not an array.
+     */
+    size_t CopyArrayTo(double *values, size_t count,
+                       std::vector<size_t> *mismatches = nullptr) const;
+    /// @overload
+    size_t CopyArrayTo(float *values, size_t count,
+                       std::vector<size_t> *mismatches = nullptr) const;
+    /// @overload
+    size_t CopyArrayTo(int64_t *values, size_t count,
+                       std::vector<size_t> *mismatches = nullptr) const;
+
+    /**
+     * @brief Copies the array's numbers into a vector, which is first sized to the array.
+     * @details Items that cannot be read are left as zero and reported
+     *      in @c mismatches, as with CopyArrayTo(double*, size_t, std::vector<size_t>*).
+     * @param[out] values The vector to fill (emptied if this is not an array).
+     * @param[out] mismatches If not null, receives the indices of the items
+     *      that could not be read.
+     * @return The number of items read.
+     */
+    size_t CopyArrayTo(std::vector<double> &values,
+                       std::vector<size_t> *mismatches = nullptr) const;
+    /// @overload
+    size_t CopyArrayTo(std::vector<float> &values,
+                       std::vector<size_t> *mismatches = nullptr) const;
+    /// @overload
+    size_t CopyArrayTo(std::vector<int64_t> &values,
+                       std::vector<size_t> *mismatches = nullptr) const;
+
+    /**
+     * @brief Copies a numeric property of each object in the array, in one pass
+     *      (e.g., the @c "width" of every item in an array of resolutions).
+     * @details The name is converted once, and items that are not objects, lack
+     *      the property or whose property cannot be read as the type are
+     *      reported in @c mismatches (their slot is left unchanged).
+     * @param name The name of the property to read from each item.
+     * @param values The buffer to write to (or a vector, which is sized to the array).
+     * @param count The number of values that @c values can hold.
+     * @param[out] mismatches If not null, receives the indices of the items
+     *      that could not be read.
+     * @param caseSensitive @c true to match the name exactly.
+     * @return The number of items read (the array's size, up to @c count),
+     *      or 0 if this is not an array.
+     */
+    size_t CopyArrayPropertyTo(const wxString &name, double *values, size_t count,
+                               std::vector<size_t> *mismatches = nullptr,
+                               bool caseSensitive = false) const;
+    /// @overload
+    size_t CopyArrayPropertyTo(const wxString &name, float *values, size_t count,
+                               std::vector<size_t> *mismatches = nullptr,
+                               bool caseSensitive = false) const;
+    /// @overload
+    size_t CopyArrayPropertyTo(const wxString &name, int64_t *values, size_t count,
+                               std::vector<size_t> *mismatches = nullptr,
+                               bool caseSensitive = false) const;
+    /// @overload
+    size_t CopyArrayPropertyTo(const wxString &name, std::vector<double> &values,
+                               std::vector<size_t> *mismatches = nullptr,
+                               bool caseSensitive = false) const;
+    /// @overload
+    size_t CopyArrayPropertyTo(const wxString &name, std::vector<float> &values,
+                               std::vector<size_t> *mismatches = nullptr,
+                               bool caseSensitive = false) const;
+    /// @overload
+    size_t CopyArrayPropertyTo(const wxString &name, std::vector<int64_t> &values,
+                               std::vector<size_t> *mismatches = nullptr,
+                               bool caseSensitive = false) const;
+
     /**
      * @brief Returns a node's property (by name).
      * @param name The name of the property to get.
+     * @param caseSensitive @c true to match the name exactly (as the JSON
+     *      specification requires), which is also faster. By default,
+     *      the name is compared case insensitively.
      * @return The property (as a node) if found. Call IsOk() to validate it.
      */
-    wxSimpleJSON::Ptr_t GetProperty(const wxString &name) const;
+    wxSimpleJSON::Ptr_t GetProperty(const wxString &name, bool caseSensitive = false) const;
 
     /**
      * @brief Deletes property with a given name,
      * @param name The name of the property to delete.
+     * @param caseSensitive @c true to match the name exactly.
      * @return @c true if the property was successfully deleted.
      */
-    bool DeleteProperty(const wxString &name);
+    bool DeleteProperty(const wxString &name, bool caseSensitive = false);
 
     /**
      * @brief Deletes a property with a given zero-based array index.
@@ -316,13 +1346,87 @@ class JSON_API_EXPORT wxSimpleJSON
      * @brief Check if node contains the specific Key.
        @details Returns @c false if the property cannot be found.
        @param name The name of the property to check for.
+       @param caseSensitive @c true to match the name exactly.
        @return @c true if the node contains the specified property.
      */
-     bool HasProperty(const wxString& name);
+     bool HasProperty(const wxString& name, bool caseSensitive = false) const;
+
+    /**
+     * @brief Returns the node that a JSON Pointer (RFC 6901) refers to.
+     * @details The pointer is a list of property names and array indices,
+     *      each preceded by a @c '/' (e.g., @c "/resolutions/2/height"), where
+     *      @c "~1" stands for a @c '/' in a name and @c "~0" for a @c '~'.
+     *      The empty pointer refers to this node. Names are matched exactly and,
+     *      unlike a chain of GetProperty() calls, no intermediate nodes are created.
+     * @param pointer The JSON Pointer.
+     * @return The node (call IsOk() to validate it), which is invalid if the
+     *      pointer is malformed or does not lead anywhere.
+     * @sa Path, to evaluate the same pointer many times.
+     */
+     wxSimpleJSON::Ptr_t At(const wxString &pointer) const;
+     /// @overload
+     /// @note Unlike the wxString overload, this does not convert the pointer.
+     wxSimpleJSON::Ptr_t At(const char *pointer) const;
+     /// @brief Returns the node that a compiled path refers to.
+     wxSimpleJSON::Ptr_t At(const Path &path) const;
+
+    /**
+     * @brief Builds a hash index of this object's property names.
+     * @details Looking up a property normally scans the object's properties
+     *      one by one. Once indexed, GetProperty(), HasProperty() and
+     *      DeleteProperty() called through this handle find properties in
+     *      constant time, which pays off for large objects that are queried
+     *      many times. Add() and DeleteProperty() called through this handle
+     *      keep the index up to date.
+     * @note The index belongs to this handle, not to the node, so hold on to the
+     *      handle for the lookups. If the object is changed through another
+     *      handle, the index is rebuilt on its next use.
+     * @return @c true if the index was built (i.e., this node is an object).
+     */
+     bool BuildIndex();
+
+     /// @brief Removes the index created by BuildIndex().
+     void ClearIndex()
+        { m_index.reset(); }
+
+     /// @returns @c true if this handle has a property index.
+     bool HasIndex() const
+        { return (m_index.get() != nullptr); }
+
+    /**
+     * @brief Keeps the printed text of the document's arrays and objects
+     *      between calls to Print(), PrintUTF8(), Write() and Save().
+     * @details Normally, every call serializes the whole document again.
+     *      With the cache, only the arrays and objects that were changed
+     *      (through Add(), ArrayAdd(), DeleteProperty() and the like) since
+     *      they were last printed, and the ones containing them, are serialized
+     *      again; the text of everything else is copied from the cache.
+     *      Re-printing a large document after a small edit then mostly costs
+     *      copying its text. Compact and pretty-printed text are cached separately.
+     * @note The cache is shared with the handles into the document obtained
+     *      from this one (GetProperty(), Item(), iterating, etc.) after this call.
+     *      Enable it on the root before taking those handles: changes made
+     *      through handles obtained earlier would not be seen by the cache.
+     * @warning The cache holds about as much memory as the printed text, and
+     *      since printing updates it, a document with a print cache must not be
+     *      printed from several threads at once.
+     */
+     void EnablePrintCache();
+
+     /// @brief Disables and frees the cache created by EnablePrintCache()
+     ///     (for every handle into the document).
+     void ClearPrintCache();
+
+     /// @returns @c true if this handle prints through a cache.
+     bool HasPrintCache() const;
 
     /**
      * @brief Get the value type that this node contains.
      * @returns The node's value type.
+     * @note The node can be changed (or, in a lazy document, parsed) through
+     *      any handle into it, so this reads its type each time, in a call into
+     *      the library (as do the @c IsValue...() functions below). To check
+     *      the types of many nodes, use GetView(), whose type checks are inline.
      */
      wxSimpleJSON::JSONType GetType() const;
 
@@ -349,10 +1453,28 @@ class JSON_API_EXPORT wxSimpleJSON
      /// @returns @c true if the node's value type is a boolean.
      bool IsValueBoolean() const
         {
-        return (GetType() == wxSimpleJSON::JSONType::IS_TRUE ||
-                GetType() == wxSimpleJSON::JSONType::IS_FALSE);
+        return (GetType() & (wxSimpleJSON::JSONType::IS_TRUE |
+                             wxSimpleJSON::JSONType::IS_FALSE)) != 0;
         }
 
+    /**
+     * @brief Checks this node against a schema.
+     * @details The document is checked in a single pass: each node's type is
+     *      compared with a mask of the types the schema allows, and each
+     *      object's properties are matched with the schema's by walking them once.
+     *      For example:
+     * @code
+     *  const wxSimpleJSON::Schema schema(wxSimpleJSON::LoadFile(wxFileName(L"c:/service/config.schema.json"))->GetView());
+     *  wxString error;
+     *  if (!config->Validate(schema, &error))
+     *      { wxLogError(error); }
+     * @endcode
+     * @param schema The schema.
+     * @param[out] error If not null, receives where and why the node doesn't match.
+     * @return @c true if the node matches the schema.
+     */
+    bool Validate(const Schema &schema, wxString *error = nullptr) const;
+
     /**
      * @brief Gets Object Keys.
      * @param conv The (optional) encoding to read the keys with.
@@ -360,6 +1482,16 @@ class JSON_API_EXPORT wxSimpleJSON
      */
      wxArrayString GetObjectKeys(const wxMBConv &conv = wxConvUTF8);
 
+    /**
+     * @brief Gets the object's keys as views of their UTF-8 text.
+     * @details Unlike GetObjectKeys(), this neither converts nor copies the keys.
+     * @return The keys, which are only valid while the properties are part of the document.
+     */
+     std::vector<UTF8View> GetObjectKeysUTF8() const;
+
+    /// @returns The node's name (as UTF-8) if it is an object's property, or a null view.
+     UTF8View GetNameUTF8() const;
+
     /**
      * @brief Converts this JSON object to string.
      * @details This is useful for debugging or displaying the JSON
@@ -369,6 +1501,1091 @@ class JSON_API_EXPORT wxSimpleJSON
      * @return The JSON object as a string.
      */
     wxString Print(bool pretty = true, const wxMBConv &conv = wxConvUTF8) const;
+
+    /**
+     * @brief Converts this JSON object to a UTF-8 encoded string.
+     * @details Unlike Print(), this does not convert the text to a wxString,
+     *      making it the cheaper choice when the text is going to be
+     *      written or sent somewhere as bytes.
+     * @param pretty @c true to apply indentations + spacing.
+     * @return The JSON object as UTF-8 text.
+     */
+    std::string PrintUTF8(bool pretty = true) const;
+
+    /**
+     * @brief Converts this JSON object to UTF-8 text in a string of the caller's.
+     * @details The string's content is replaced, but its memory is reused, so
+     *      printing into the same string over and over doesn't allocate once it
+     *      is large enough.
+     * @param[out] text The string to print into.
+     * @param pretty @c true to apply indentations + spacing.
+     * @return @c false (leaving @c text empty) if the node is invalid.
+     */
+    bool PrintUTF8(std::string &text, bool pretty = true) const;
+
+    /**
+     * @brief Serializes this JSON object, passing the text to a callback.
+     * @details The text is produced incrementally through a small fixed-size
+     *      buffer, so the full document is never held in memory.
+     *      The output is identical to PrintUTF8().
+     * @param sink The callback receiving each chunk of UTF-8 text.
+     * @param pretty @c true to apply indentations + spacing.
+     * @return @c true if the whole object was written; @c false if the node
+     *      is invalid or the callback aborted.
+     */
+    bool Write(const WriteCallback &sink, bool pretty = true) const;
+    /**
+     * @brief Serializes this JSON object to a stream as UTF-8 text.
+     * @param stream The stream to write to.
+     * @param pretty @c true to apply indentations + spacing.
+     * @return @c true if the whole object was written.
+     */
+    bool Write(wxOutputStream &stream, bool pretty = true) const;
+    /**
+     * @brief Serializes this JSON object to a file handle as UTF-8 text.
+     * @param fp The file to write to.
+     * @param pretty @c true to apply indentations + spacing.
+     * @return @c true if the whole object was written.
+     */
+    bool Write(FILE *fp, bool pretty = true) const;
+
+    /**
+     * @brief Encodes this JSON object as CBOR (RFC 8949), passing the bytes to a callback.
+     * @details CBOR is a binary encoding of the same data model, which is smaller
+     *      than JSON text and much quicker to read back: strings are prefixed
+     *      with their lengths (rather than scanned for quotes and escapes) and
+     *      numbers are stored in binary (whole numbers as integers, others as
+     *      the smallest float that holds them exactly), so reading them back
+     *      with CreateFromBinary() or LoadBinary() gives exactly the same values.
+     *      Raw JSON (IS_RAW) is stored as a text string tagged as embedded JSON (tag 262).
+     *      NaN and infinities (which JSON has no way to write) are stored as null,
+     *      as Print() writes them.
+     * @param sink The callback receiving each chunk of the encoded data.
+     * @return @c true if the whole object was written; @c false if the node
+     *      is invalid or the callback aborted.
+     */
+    bool WriteBinary(const WriteCallback &sink) const;
+    /**
+     * @brief Encodes this JSON object as CBOR into a string of the caller's.
+     * @param[out] data The string to replace with the encoded data (its memory is reused).
+     * @return @c false (leaving @c data empty) if the node is invalid.
+     */
+    bool WriteBinary(std::string &data) const;
+    /**
+     * @brief Saves this JSON object to a file, encoded as CBOR.
+     * @param filename The file path to save to.
+     * @return @c true if the file save succeeded; @c false otherwise.
+     * @sa LoadBinary().
+     */
+    bool SaveBinary(const wxFileName &filename) const;
+
+    /**
+     * @brief Writes this JSON object as a compiled document, for MapFile().
+     * @details A compiled document is a position-independent image of the tree:
+     *      nodes are stored in one flat array (with the children of each array
+     *      or object next to each other, so items are found by index), strings
+     *      in one block, and every object's property names are also sorted,
+     *      so that large objects are searched by bisection.
+     *      Nothing in it is a pointer, so it can be mapped into memory and read
+     *      as it is. It uses the machine's byte order and isn't meant for
+     *      exchanging documents (see WriteBinary() for that).
+     * @param sink The callback receiving each chunk of the compiled document.
+     * @return @c true if the whole object was written; @c false if the node
+     *      is invalid or the callback aborted.
+     */
+    bool WriteCompiled(const WriteCallback &sink) const;
+    /**
+     * @brief Saves this JSON object to a file as a compiled document.
+     * @param filename The file path to save to.
+     * @return @c true if the file save succeeded; @c false otherwise.
+     * @sa MapFile().
+     */
+    bool SaveCompiled(const wxFileName &filename) const;
+};
+
+/// @brief Forward iterator over the children of an array or object node.
+/// @details The node returned from dereferencing is borrowed from the
+///     iterator and is only valid until the iterator is advanced.
+class JSON_API_EXPORT wxSimpleJSON::iterator
+{
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = wxSimpleJSON;
+    using difference_type = std::ptrdiff_t;
+    using pointer = wxSimpleJSON*;
+    using reference = wxSimpleJSON&;
+
+    iterator() = default;
+
+    reference operator*() const { return m_node; }
+    pointer operator->() const { return &m_node; }
+
+    iterator &operator++();
+    iterator operator++(int)
+        {
+        iterator tmp(*this);
+        ++(*this);
+        return tmp;
+        }
+
+    bool operator==(const iterator &that) const
+        { return m_node.m_d == that.m_node.m_d; }
+    bool operator!=(const iterator &that) const
+        { return m_node.m_d != that.m_node.m_d; }
+
+  private:
+    friend class wxSimpleJSON;
+    iterator(cJSON *node, const wxSimpleJSON &parent);
+
+    mutable wxSimpleJSON m_node;
+};
+
+/// @brief Forward iterator over the children of a wxSimpleJSON::View.
+class JSON_API_EXPORT wxSimpleJSON::View::iterator
+{
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = wxSimpleJSON::View;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const wxSimpleJSON::View*;
+    using reference = wxSimpleJSON::View;
+
+    iterator() = default;
+
+    reference operator*() const { return m_node; }
+    pointer operator->() const { return &m_node; }
+
+    iterator &operator++();
+    iterator operator++(int)
+        {
+        iterator tmp(*this);
+        ++(*this);
+        return tmp;
+        }
+
+    bool operator==(const iterator &that) const
+        { return m_node == that.m_node; }
+    bool operator!=(const iterator &that) const
+        { return m_node != that.m_node; }
+
+  private:
+    friend class wxSimpleJSON::View;
+    explicit iterator(wxSimpleJSON::View node) : m_node(node) {}
+
+    wxSimpleJSON::View m_node;
+};
+
+/**
+ * @brief A JSON Pointer (RFC 6901), compiled once to be evaluated against many documents.
+ * @details The pointer is split and unescaped up front: property names are kept
+ *      UTF-8 encoded and array indices as numbers, so evaluating it neither
+ *      converts nor allocates anything.
+ * @code
+ *  const wxSimpleJSON::Path height("/resolutions/2/height");
+ *  for (const auto &monitor : monitors)
+ *      {
+ *      const auto value = monitor->GetView().At(height).GetValueNumber();
+ *      }
+ * @endcode
+ */
+class JSON_API_EXPORT wxSimpleJSON::Path
+{
+  public:
+    /// @brief Constructs the empty pointer, which refers to the whole document.
+    Path() = default;
+    /// @brief Compiles a JSON Pointer (e.g., @c "/a/b/2").
+    explicit Path(const wxString &pointer);
+    /// @brief Compiles a UTF-8 encoded JSON Pointer.
+    explicit Path(const char *pointer)
+        { Compile(pointer, (pointer != nullptr) ? std::strlen(pointer) : 0); }
+    /// @brief Compiles a UTF-8 encoded JSON Pointer of @c length bytes.
+    Path(const char *pointer, size_t length)
+        { Compile(pointer, length); }
+
+    /// @returns @c false if the pointer was malformed (in which case it refers to nothing).
+    bool IsOk() const { return m_ok; }
+    /// @returns The number of steps (property names or indices) in the path.
+    size_t GetDepth() const { return m_tokens.size(); }
+
+    /// @returns The node that the path refers to, starting from @c root, or a null view.
+    View Evaluate(const View &root) const;
+    /// @returns The node that the path refers to, starting from @c root, or a null handle.
+    MappedNode Evaluate(const MappedNode &root) const;
+
+  private:
+    struct Token
+    {
+        // the unescaped property name, UTF-8 encoded
+        std::string m_name;
+        // the array index, or -1 if the name is not one
+        size_t m_index{ static_cast<size_t>(-1) };
+    };
+
+    void Compile(const char *pointer, size_t length);
+
+    std::vector<Token> m_tokens;
+    bool m_ok{ true };
+};
+
+/**
+ * @brief A JSON Schema, compiled for checking documents with wxSimpleJSON::Validate().
+ * @details These keywords are supported:
+ *      - @c type (a name or an array of names, including @c "integer")
+ *      - @c enum and @c const (of null, boolean, number and string values)
+ *      - @c minimum, @c maximum, @c exclusiveMinimum and @c exclusiveMaximum (numbers)
+ *      - @c minLength and @c maxLength (in code points)
+ *      - @c items (a single schema for every item), @c minItems and @c maxItems
+ *      - @c properties, @c required and @c additionalProperties
+ *
+ *      @c true and @c false are also schemas (matching everything and nothing).
+ *      Other keywords (including @c $ref and combinations such as @c anyOf) are ignored,
+ *      as JSON Schema does with keywords it doesn't know.
+ *      A schema can be shared between threads once compiled.
+ */
+class JSON_API_EXPORT wxSimpleJSON::Schema
+{
+  public:
+    /// @brief Constructs a schema that everything matches.
+    Schema() = default;
+    /// @brief Compiles a schema from its definition (see IsOk()).
+    explicit Schema(const View &definition);
+
+    /// @returns @c false if the definition was malformed (see GetLastError()),
+    ///     in which case nothing matches the schema.
+    bool IsOk() const { return m_error.empty(); }
+    /// @returns Where and why the definition was malformed.
+    const wxString &GetLastError() const { return m_error; }
+
+    /// @brief Checks a node against the schema (see wxSimpleJSON::Validate()).
+    bool Validate(const View &node, wxString *error = nullptr) const;
+
+  private:
+    static const size_t NoNode = static_cast<size_t>(-1);
+
+    // a schema, or the schema of a nested value
+    struct Node
+    {
+        // the JSONType values that are allowed (and whether integers are)
+        int m_types{ 0 };
+        double m_minimum{ -std::numeric_limits<double>::infinity() };
+        double m_maximum{ std::numeric_limits<double>::infinity() };
+        bool m_exclusiveMinimum{ false };
+        bool m_exclusiveMaximum{ false };
+        size_t m_minLength{ 0 };
+        size_t m_maxLength{ SIZE_MAX };
+        size_t m_minItems{ 0 };
+        size_t m_maxItems{ SIZE_MAX };
+        // the schema of the items (NoNode for any)
+        size_t m_items{ NoNode };
+        // the range of the properties in m_properties
+        size_t m_firstProperty{ 0 };
+        size_t m_propertyCount{ 0 };
+        size_t m_requiredCount{ 0 };
+        // the schema of other properties (NoNode for any)
+        size_t m_additionalProperties{ NoNode };
+        // the range of the allowed values in m_enumValues (if there is an enum)
+        bool m_hasEnum{ false };
+        size_t m_firstEnumValue{ 0 };
+        size_t m_enumValueCount{ 0 };
+    };
+
+    // a property of an object schema
+    struct Property
+    {
+        // the UTF-8 encoded name
+        std::string m_name;
+        size_t m_node{ NoNode };
+        bool m_required{ false };
+    };
+
+    // a value of an enum (or const)
+    struct EnumValue
+    {
+        int m_type{ 0 };
+        double m_number{ 0 };
+        std::string m_text;
+    };
+
+    // the state of a Validate() call
+    struct Validation;
+
+    size_t Compile(const View &definition, const wxString &path);
+    bool ValidateNode(size_t index, const cJSON *node, Validation &validation) const;
+
+    std::vector<Node> m_nodes;
+    // each object schema's properties, in order of their names (by length, then bytes)
+    std::vector<Property> m_properties;
+    std::vector<EnumValue> m_enumValues;
+    wxString m_error;
+};
+
+/**
+ * @brief A handle to a node of a frozen (immutable) document, from wxSimpleJSON::Freeze().
+ * @details A frozen document can't be changed, so any number of threads can read
+ *      it at once without locking. Every handle shares ownership of the document,
+ *      which stays alive until the last handle into it (the root's or any
+ *      other node's) is destroyed.
+ *      Handles are small values; copying one updates the document's (atomic)
+ *      reference count, so in tight loops, read through GetView() instead,
+ *      which is just as safe while the handle it came from exists.
+ * @code
+ *  // on the main thread
+ *  const wxSimpleJSON::FrozenNode config = wxSimpleJSON::LoadFile(configPath)->Freeze();
+ *  // on any number of worker threads
+ *  const auto servers = config.GetProperty("servers");
+ *  const auto port = servers.Item(0).GetView().GetProperty("port").GetValueNumber();
+ * @endcode
+ */
+class JSON_API_EXPORT wxSimpleJSON::FrozenNode
+{
+  public:
+    /// @brief Constructs a null handle.
+    FrozenNode() = default;
+
+    /// @returns @c true if the handle does not refer to a node.
+    bool IsNull() const { return m_view.IsNull(); }
+    /// @returns @c true if the handle refers to a node.
+    bool IsOk() const { return m_view.IsOk(); }
+
+    /// @returns A view of the node, for the rest of the read API.
+    ///     The view is valid for as long as this handle (or any other into the document) is.
+    View GetView() const { return m_view; }
+    /// @returns The node's value type.
+    wxSimpleJSON::JSONType GetType() const { return m_view.GetType(); }
+    /// @returns The number of items in the array, or 0 if this is not an array.
+    size_t ArraySize() const { return m_view.ArraySize(); }
+
+    /// @returns The array item at @c index, or a null handle.
+    FrozenNode Item(size_t index) const { return Share(m_view.Item(index)); }
+    /// @returns The property called @c name, or a null handle.
+    FrozenNode GetProperty(const wxString &name, bool caseSensitive = false) const
+        { return Share(m_view.GetProperty(name, caseSensitive)); }
+    /// @returns The property called @c name (UTF-8 encoded), or a null handle.
+    FrozenNode GetProperty(const char *name, bool caseSensitive = false) const
+        { return Share(m_view.GetProperty(name, caseSensitive)); }
+    /// @returns The node that a JSON Pointer refers to, or a null handle.
+    FrozenNode At(const wxString &pointer) const { return Share(m_view.At(pointer)); }
+    /// @returns The node that a UTF-8 encoded JSON Pointer refers to, or a null handle.
+    FrozenNode At(const char *pointer) const { return Share(m_view.At(pointer)); }
+    /// @returns The node that a compiled path refers to, or a null handle.
+    FrozenNode At(const Path &path) const { return Share(m_view.At(path)); }
+
+    /**
+     * @brief Returns a handle to another node of this document.
+     * @param node A view of a node in the same document (e.g., from iterating
+     *      through GetView()), which the new handle keeps alive.
+     * @return The handle, or a null handle if @c node is null.
+     */
+    FrozenNode Share(const View &node) const
+        { return node.IsOk() ? FrozenNode(m_storage, node) : FrozenNode(); }
+
+    /// @returns The node as JSON text.
+    wxString Print(bool pretty = true, const wxMBConv &conv = wxConvUTF8) const
+        { return m_view.Print(pretty, conv); }
+    /// @returns The node as UTF-8 encoded JSON text.
+    std::string PrintUTF8(bool pretty = true) const
+        { return m_view.PrintUTF8(pretty); }
+    /// @brief Serializes the node, passing the text to a callback.
+    bool Write(const WriteCallback &sink, bool pretty = true) const
+        { return m_view.Write(sink, pretty); }
+
+  private:
+    friend class wxSimpleJSON;
+    FrozenNode(const wxSharedPtr<DocumentStorage> &storage, const View &node)
+        : m_storage(storage), m_view(node)
+        {}
+
+    // the arena holding the document
+    wxSharedPtr<DocumentStorage> m_storage;
+    View m_view;
+};
+
+/**
+ * @brief A handle to a node of a compiled document mapped into memory, from wxSimpleJSON::MapFile().
+ * @details Mapped documents are read-only; nodes and strings are read straight
+ *      from the mapped file, so reading neither parses nor allocates (except
+ *      for the functions returning wxStrings or vectors). Like frozen documents,
+ *      they can be read from any number of threads at once, and every handle
+ *      shares ownership of the mapping, which stays until the last handle into
+ *      it is destroyed.
+ *      To change a mapped document, Copy() it into a regular one.
+ * @code
+ *  // once, when the reference data changes
+ *  wxSimpleJSON::LoadFile(referencePath)->SaveCompiled(compiledPath);
+ *  // at every startup
+ *  const auto reference = wxSimpleJSON::MapFile(compiledPath);
+ *  const auto rate = reference.At("/rates/EUR").GetValueNumber();
+ * @endcode
+ */
+class JSON_API_EXPORT wxSimpleJSON::MappedNode
+{
+  public:
+    class iterator;
+
+    /// @brief Constructs a null handle.
+    MappedNode() = default;
+
+    /// @returns @c true if the handle does not refer to a node.
+    bool IsNull() const { return !m_file; }
+    /// @returns @c true if the handle refers to a node.
+    bool IsOk() const { return !IsNull(); }
+
+    /// @returns The node's value type.
+    /// @note This reads the type from the mapping, in a call into the library.
+    wxSimpleJSON::JSONType GetType() const;
+
+    /// @returns @c true if the node's value type is a string.
+    bool IsValueString() const
+        { return GetType() == wxSimpleJSON::JSONType::IS_STRING; }
+    /// @returns @c true if the node's value type is a number.
+    bool IsValueNumber() const
+        { return GetType() == wxSimpleJSON::JSONType::IS_NUMBER; }
+    /// @returns @c true if the node's value type is null.
+    bool IsValueNull() const
+        { return GetType() == wxSimpleJSON::JSONType::IS_NULL; }
+    /// @returns @c true if the node's value type is an array.
+    bool IsValueArray() const
+        { return GetType() == wxSimpleJSON::JSONType::IS_ARRAY; }
+    /// @returns @c true if the node's value type is an object.
+    bool IsValueObject() const
+        { return GetType() == wxSimpleJSON::JSONType::IS_OBJECT; }
+    /// @returns @c true if the node's value type is a boolean.
+    bool IsValueBoolean() const
+        {
+        const auto type = GetType();
+        return (type == wxSimpleJSON::JSONType::IS_TRUE ||
+                type == wxSimpleJSON::JSONType::IS_FALSE);
+        }
+
+    /// @returns The number of items in the array, or 0 if this is not an array.
+    size_t ArraySize() const;
+    /// @returns The array item at @c index, or a null handle.
+    /// @note Items are stored next to each other, so this takes constant time.
+    MappedNode Item(size_t index) const;
+    /// @returns An iterator to the first child of an array or object.
+    iterator begin() const;
+    /// @returns The past-the-end iterator for this node's children.
+    iterator end() const;
+
+    /// @returns The property called @c name, or a null handle.
+    MappedNode GetProperty(const wxString &name, bool caseSensitive = false) const;
+    /// @returns The property called @c name (UTF-8 encoded), or a null handle.
+    MappedNode GetProperty(const char *name, bool caseSensitive = false) const;
+    /// @returns The property called @c name, or a null handle.
+    /// @note The name does not need to be null-terminated.
+    MappedNode GetProperty(const UTF8View &name, bool caseSensitive = false) const;
+    /// @returns @c true if the node has a property called @c name.
+    bool HasProperty(const wxString &name, bool caseSensitive = false) const
+        { return GetProperty(name, caseSensitive).IsOk(); }
+    /// @returns The node that a JSON Pointer (e.g., @c "/a/b/2") refers to, or a null handle.
+    MappedNode At(const wxString &pointer) const { return Path(pointer).Evaluate(*this); }
+    /// @returns The node that a UTF-8 encoded JSON Pointer refers to, or a null handle.
+    MappedNode At(const char *pointer) const { return Path(pointer).Evaluate(*this); }
+    /// @returns The node that a compiled path refers to, or a null handle.
+    MappedNode At(const Path &path) const { return path.Evaluate(*this); }
+    /// @returns The names of the object's properties.
+    wxArrayString GetObjectKeys(const wxMBConv &conv = wxConvUTF8) const;
+    /// @returns The names of the object's properties, without copying them.
+    std::vector<UTF8View> GetObjectKeysUTF8() const;
+    /// @returns The node's name if it is an object's property, or a null view.
+    UTF8View GetNameUTF8() const;
+
+    /// @returns The node's string value, or @c defaultValue.
+    wxString GetValueString(const wxString &defaultValue = wxEmptyString,
+                            const wxMBConv &conv = wxConvUTF8) const;
+    /// @returns The node's string value without copying it,
+    ///     or a null view if the node is not a string.
+    /// @note The view points into the mapping, and is valid as long as any handle into it is.
+    UTF8View GetValueStringUTF8() const;
+    /// @returns The node's boolean value, or @c defaultValue.
+    bool GetValueBool(bool defaultValue = false) const;
+    /// @returns The node's numeric value, or @c defaultValue.
+    double GetValueNumber(double defaultValue = -1) const;
+    /// @returns The array's values as booleans.
+    std::vector<bool> GetValueArrayBool(bool defaultValue = false) const;
+    /// @returns The array's values as strings.
+    wxArrayString GetValueArrayString(const wxMBConv &conv = wxConvUTF8) const;
+    /// @returns The array's values as views of their text
+    ///     (null views for items that are not strings).
+    std::vector<UTF8View> GetValueArrayStringUTF8() const;
+    /// @returns The array's values as numbers.
+    std::vector<double> GetValueArrayNumber(double defaultValue = -1) const;
+
+    /// @returns A copy of the node (and everything in it) as a regular document,
+    ///     which can be changed, or an invalid node if this handle is null.
+    Ptr_t Copy() const;
+    /// @returns The node as JSON text.
+    wxString Print(bool pretty = true, const wxMBConv &conv = wxConvUTF8) const
+        { return Copy()->Print(pretty, conv); }
+    /// @returns The node as UTF-8 encoded JSON text.
+    std::string PrintUTF8(bool pretty = true) const
+        { return Copy()->PrintUTF8(pretty); }
+
+    bool operator==(const MappedNode &that) const
+        { return (m_file == that.m_file && m_index == that.m_index); }
+    bool operator!=(const MappedNode &that) const { return !(*this == that); }
+
+  private:
+    friend class wxSimpleJSON;
+    MappedNode(const wxSharedPtr<MappedStorage> &file, size_t index)
+        : m_file(file), m_index(index)
+        {}
+
+    // the mapped file (null for a null handle)
+    wxSharedPtr<MappedStorage> m_file;
+    // the node's index in the file's node array
+    size_t m_index{ 0 };
+};
+
+/// @brief Forward iterator over the children of a mapped array or object node.
+class JSON_API_EXPORT wxSimpleJSON::MappedNode::iterator
+{
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = MappedNode;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const MappedNode*;
+    using reference = const MappedNode&;
+
+    iterator() = default;
+
+    reference operator*() const { return m_node; }
+    pointer operator->() const { return &m_node; }
+
+    /// @brief Moves to the next child (which is stored right after this one).
+    iterator &operator++()
+        {
+        ++m_node.m_index;
+        return *this;
+        }
+    iterator operator++(int)
+        {
+        iterator tmp(*this);
+        ++(*this);
+        return tmp;
+        }
+
+    bool operator==(const iterator &that) const
+        { return m_node == that.m_node; }
+    bool operator!=(const iterator &that) const
+        { return m_node != that.m_node; }
+
+  private:
+    friend class wxSimpleJSON::MappedNode;
+    explicit iterator(const MappedNode &node) : m_node(node) {}
+
+    MappedNode m_node;
+};
+
+/**
+ * @brief A reusable document, for parsing one text after another (e.g., a request
+ *      per call) without allocating and freeing every node each time.
+ * @details The document's nodes and strings are allocated from an arena that is
+ *      recycled by the next Parse() (or Clear()), along with the root's handle,
+ *      so once the arena has grown to fit the texts being parsed, parsing UTF-8
+ *      text doesn't allocate at all.
+ *      Memory is only recycled once nothing refers to the previous document
+ *      anymore: while a handle into it is still held, the next Parse() allocates
+ *      a new arena (and the old one is freed with the last handle).
+ * @code
+ *  wxSimpleJSON::Document document;
+ *  std::string reply;
+ *  while (server.Receive(request))
+ *      {
+ *      const auto json = document.Parse(request.data(), request.length());
+ *      ...
+ *      json->PrintUTF8(reply, false);
+ *      }
+ * @endcode
+ */
+class JSON_API_EXPORT wxSimpleJSON::Document
+{
+  public:
+    Document() = default;
+    Document(const Document&) = delete;
+    Document& operator=(const Document&) = delete;
+    ~Document();
+
+    /**
+     * @brief Parses UTF-8 encoded JSON text, replacing the previous document.
+     * @param data The text (does not need to be null terminated).
+     * @param length The number of bytes in @c data.
+     * @return The root node. If the text isn't valid JSON, this is an invalid
+     *      node whose GetLastError() describes the problem.
+     */
+    Ptr_t Parse(const char *data, size_t length);
+    /// @overload
+    /// @note The text is converted to UTF-8 first, which allocates.
+    Ptr_t Parse(const wxString &text, const wxMBConv &conv = wxConvUTF8);
+
+    /// @returns The root node of the last document parsed
+    ///     (an invalid node before the first Parse() and after Clear()).
+    Ptr_t GetRoot() const;
+
+    /// @brief Frees the document, keeping its memory for the next Parse().
+    void Clear();
+
+  private:
+    /// @brief Parses text encoded with @c conv (which is only used for error messages).
+    Ptr_t ParseEncoded(const char *data, size_t length, const wxMBConv &conv);
+    void Recycle();
+
+    wxSharedPtr<DocumentStorage> m_storage;
+    Ptr_t m_root;
 };
 
+/**
+ * @brief Event-driven (SAX style) JSON parser.
+ * @details Reads a document incrementally and reports its structure and values
+ *      to a wxSimpleJSON::EventHandler without building a tree, so memory use is
+ *      bounded by the read buffer, the longest single key/string/number and the
+ *      nesting depth rather than by the size of the document.
+ *      The input must be UTF-8 and the accepted syntax matches wxSimpleJSON::Create().
+ * @code
+ *  class CountNames : public wxSimpleJSON::EventHandler
+ *      {
+ *    public:
+ *      bool OnKey(const char *key, size_t length) override
+ *          {
+ *          if (length == 4 && std::memcmp(key, "name", 4) == 0)
+ *              { ++m_names; }
+ *          return true;
+ *          }
+ *      size_t m_names{ 0 };
+ *      };
+ *
+ *  CountNames counter;
+ *  wxSimpleJSON::EventReader reader(counter);
+ *  if (!reader.Parse(wxFileName(L"export.json")))
+ *      { wxLogError(reader.GetLastError()); }
+ * @endcode
+ */
+class JSON_API_EXPORT wxSimpleJSON::EventReader
+{
+  public:
+    /**
+     * @brief Constructor.
+     * @param handler The handler receiving the parsing events.
+     * @param bufferSize The number of bytes read from the input at a time.
+     */
+    explicit EventReader(EventHandler &handler, size_t bufferSize = 64 * 1024)
+        : m_handler(handler), m_bufferSize(bufferSize > 0 ? bufferSize : 1)
+        {}
+
+    /**
+     * @brief Parses a document read from a stream.
+     * @param stream The stream to read from.
+     * @return @c true if the whole document was parsed, @c false if it was
+     *      malformed (see GetLastError()) or a handler stopped parsing.
+     */
+    bool Parse(wxInputStream &stream);
+    /**
+     * @brief Parses a document read from a file.
+     * @param filename The file to read from.
+     * @return @c true if the whole document was parsed.
+     */
+    bool Parse(const wxFileName &filename);
+    /**
+     * @brief Parses a document in memory.
+     * @param data The UTF-8 JSON text.
+     * @param length The length of @c data in bytes.
+     * @return @c true if the whole document was parsed.
+     */
+    bool Parse(const char *data, size_t length);
+
+    /**
+     * @returns The error from the last call to Parse(), in the same format as
+     *      wxSimpleJSON::GetLastError(). Empty if parsing succeeded or was
+     *      stopped by the handler.
+     * @note Only the part of the offending line still in the read buffer is quoted.
+     */
+    const wxString& GetLastError() const { return m_lastError; }
+
+  private:
+    EventHandler &m_handler;
+    size_t m_bufferSize{ 0 };
+    wxString m_lastError;
+};
+
+/**
+ * @brief Reads newline-delimited JSON (JSON Lines), one record per line.
+ * @details Lines are read through a buffer (which grows to fit the longest line)
+ *      and parsed straight from it, without converting them to wxString.
+ *      Blank lines are skipped.
+ *
+ *      With node reuse (the default), records are parsed into an arena that is
+ *      recycled for the next record once nothing refers to the previous one,
+ *      so reading a file of similar records settles into not allocating at all.
+ *      Records (and properties from them) that are still held when Next() is
+ *      called stay valid; the reader then simply starts a new arena.
+ * @code
+ *  wxSimpleJSON::NDJSONReader reader(wxFileName(L"events.ndjson"));
+ *  wxSimpleJSON::Ptr_t record;
+ *  while (reader.Next(record))
+ *      {
+ *      if (!record->IsOk())
+ *          {
+ *          wxLogWarning(record->GetLastError());
+ *          continue;
+ *          }
+ *      const auto user = record->GetView().GetProperty("user").GetValueString();
+ *      }
+ * @endcode
+ */
+class JSON_API_EXPORT wxSimpleJSON::NDJSONReader
+{
+  public:
+    /**
+     * @brief Reads records from a stream.
+     * @param stream The stream to read from. Must outlive the reader.
+     * @param reuseNodes @c true to recycle the memory of records no longer in use.
+     * @param bufferSize The initial size of the read buffer.
+     */
+    explicit NDJSONReader(wxInputStream &stream, bool reuseNodes = true,
+                          size_t bufferSize = 64 * 1024)
+        : m_stream(&stream), m_buffer(bufferSize > 0 ? bufferSize : 1), m_reuseNodes(reuseNodes)
+        {}
+    /**
+     * @brief Reads records from a file.
+     * @param filename The file to read from.
+     * @param reuseNodes @c true to recycle the memory of records no longer in use.
+     * @param bufferSize The initial size of the read buffer.
+     */
+    explicit NDJSONReader(const wxFileName &filename, bool reuseNodes = true,
+                          size_t bufferSize = 64 * 1024)
+        : m_file(filename.GetFullPath(), "rb"), m_buffer(bufferSize > 0 ? bufferSize : 1),
+          m_reuseNodes(reuseNodes)
+        {}
+    NDJSONReader(const NDJSONReader&) = delete;
+    NDJSONReader& operator=(const NDJSONReader&) = delete;
+    ~NDJSONReader();
+
+    /// @returns @c true if the input could be opened.
+    bool IsOk() const { return (m_stream != nullptr || m_file.IsOpened()); }
+
+    /**
+     * @brief Reads the next record.
+     * @param[out] record The record. If its line isn't valid JSON, this is an
+     *      invalid node whose GetLastError() describes the problem (with the
+     *      line number in the input), and reading can continue with the next line.
+     * @return @c false once there are no more records.
+     */
+    bool Next(Ptr_t &record);
+
+    /**
+     * @brief Reads up to @c maxRecords records and parses them in parallel.
+     * @param[out] records The records, in the order they appear in the input
+     *      (each one the same as Next() would have returned, but never reused).
+     * @param maxRecords The most records to read.
+     * @param threads The number of threads to parse with (0 to use all of the CPU's cores).
+     * @return The number of records read, which is 0 once there are no more.
+     */
+    size_t NextBatch(std::vector<Ptr_t> &records, size_t maxRecords, unsigned int threads = 0);
+
+    /// @returns The (1-indexed) line number of the last record read.
+    size_t GetLineNumber() const { return m_lineNumber; }
+
+  private:
+    bool ReadLine(const char *&line, size_t &length);
+    bool ReadRecordLine(const char *&line, size_t &length);
+    static Ptr_t CreateRecordError(const char *line, size_t length, const char *parseEnd,
+                                   size_t lineNumber);
+
+    wxInputStream *m_stream{ nullptr };
+    wxFFile m_file;
+    std::vector<char> m_buffer;
+    size_t m_pos{ 0 };
+    size_t m_end{ 0 };
+    bool m_eof{ false };
+    size_t m_lineNumber{ 0 };
+    bool m_reuseNodes{ true };
+    wxSharedPtr<DocumentStorage> m_storage;
+    Ptr_t m_record;
+};
+
+/**
+ * @brief Writes newline-delimited JSON (JSON Lines), one compact record per line.
+ * @details Records are serialized like Print(false) into a buffer that is
+ *      written to the stream in large chunks, when it fills up, on Flush()
+ *      and when the writer is destroyed.
+ */
+class JSON_API_EXPORT wxSimpleJSON::NDJSONWriter
+{
+  public:
+    /**
+     * @brief Constructor.
+     * @param stream The stream to append the records to. Must outlive the writer.
+     * @param bufferSize The number of bytes to collect before writing to the stream.
+     */
+    explicit NDJSONWriter(wxOutputStream &stream, size_t bufferSize = 64 * 1024)
+        : m_stream(stream), m_bufferSize(bufferSize)
+        {}
+    NDJSONWriter(const NDJSONWriter&) = delete;
+    NDJSONWriter& operator=(const NDJSONWriter&) = delete;
+    ~NDJSONWriter() { Flush(); }
+
+    /**
+     * @brief Appends a record.
+     * @param record The node to write.
+     * @return @c false if the node is invalid or the stream failed.
+     */
+    bool Write(const View &record);
+    /// @overload
+    bool Write(const wxSimpleJSON &record) { return Write(record.GetView()); }
+
+    /**
+     * @brief Writes any buffered records to the stream.
+     * @return @c false if the stream failed.
+     */
+    bool Flush();
+
+  private:
+    wxOutputStream &m_stream;
+    size_t m_bufferSize{ 0 };
+    std::string m_buffer;
+    bool m_failed{ false };
+};
+
+/**
+ * @brief Reads an object's properties into the fields of a bound type
+ *      (used by wxSimpleJSON::To()).
+ */
+class JSON_API_EXPORT wxSimpleJSON::BindingReader
+{
+  public:
+    /// @brief The names of a bound type's fields, gathered once per type.
+    class JSON_API_EXPORT Keys
+    {
+      public:
+        /// @brief Gathers the names of @c value's fields.
+        template<typename T>
+        explicit Keys(T &value)
+            {
+            Binding<T>::VisitFields(*this, value);
+            Sort();
+            }
+        Keys(const Keys&) = delete;
+        Keys& operator=(const Keys&) = delete;
+
+        template<typename U>
+        void Field(const char *name, size_t length, const U &)
+            { m_names.emplace_back(name, length); }
+
+        /// @returns The number of fields.
+        size_t size() const { return m_names.size(); }
+        /// @returns The index of the field called @c name, or @c size() if there is none.
+        /// @param hint The field to try first (the one after the last match).
+        size_t Find(const char *name, size_t length, size_t hint) const;
+
+      private:
+        void Sort();
+
+        std::vector<UTF8View> m_names;
+        // the fields' indices, in order of their names (by length, then bytes)
+        std::vector<size_t> m_order;
+    };
+
+    /// @brief Reads the object @c node into @c value.
+    /// @returns @c false if @c node is not an object or a property couldn't be read.
+    template<typename T>
+    static bool ReadObject(const cJSON *node, T &value)
+        {
+        static const Keys keys(value);
+        BindingReader reader(node, keys);
+        Binding<T>::VisitFields(reader, value);
+        return reader.m_ok;
+        }
+
+    ~BindingReader();
+    BindingReader(const BindingReader&) = delete;
+    BindingReader& operator=(const BindingReader&) = delete;
+
+    template<typename U>
+    void Field(const char *, size_t, U &value)
+        {
+        const cJSON *node = m_matches[m_field++];
+        if (node != nullptr && !Read(node, value))
+            { m_ok = false; }
+        }
+
+  private:
+    // matches the object's properties with the fields, in one pass
+    BindingReader(const cJSON *node, const Keys &keys);
+
+    static bool Read(const cJSON *node, bool &value);
+    static bool Read(const cJSON *node, double &value);
+    static bool Read(const cJSON *node, std::string &value);
+    static bool Read(const cJSON *node, wxString &value);
+    template<typename U>
+    static typename std::enable_if<std::is_floating_point<U>::value, bool>::type
+    Read(const cJSON *node, U &value)
+        {
+        double number{ 0 };
+        if (!Read(node, number))
+            { return false; }
+        value = static_cast<U>(number);
+        return true;
+        }
+    template<typename U>
+    static typename std::enable_if<std::is_integral<U>::value, bool>::type
+    Read(const cJSON *node, U &value)
+        {
+        double number{ 0 };
+        if (!ReadInteger(node, std::is_signed<U>::value, std::numeric_limits<U>::digits, number))
+            { return false; }
+        value = static_cast<U>(number);
+        return true;
+        }
+    template<typename U, typename A>
+    static bool Read(const cJSON *node, std::vector<U, A> &values)
+        {
+        const cJSON *item{ nullptr };
+        if (!GetFirstItem(node, item))
+            { return false; }
+        values.clear();
+        bool ok{ true };
+        for (; item != nullptr; item = GetNextItem(item))
+            {
+            U value{};
+            ok = Read(item, value) && ok;
+            values.push_back(std::move(value));
+            }
+        return ok;
+        }
+    template<typename U>
+    static typename std::enable_if<std::is_class<U>::value, bool>::type
+    Read(const cJSON *node, U &value)
+        { return ReadObject(node, value); }
+
+    /// @brief Reads a whole number that fits an integer type (with @c digits value bits).
+    static bool ReadInteger(const cJSON *node, bool isSigned, int digits, double &value);
+    /// @brief Gets an array's first item (@c nullptr if it's empty).
+    /// @returns @c false if @c node is not an array.
+    static bool GetFirstItem(const cJSON *node, const cJSON *&item);
+    static const cJSON *GetNextItem(const cJSON *item);
+
+    // the property matched with each field (if any)
+    const cJSON **m_matches{ nullptr };
+    const cJSON *m_inlineMatches[16];
+    size_t m_field{ 0 };
+    bool m_ok{ true };
+};
+
+/**
+ * @brief Writes the fields of a bound type as an object's properties
+ *      (used by wxSimpleJSON::From()).
+ */
+class JSON_API_EXPORT wxSimpleJSON::BindingWriter
+{
+  public:
+    /// @brief Creates a root object from @c value.
+    template<typename T>
+    static wxSimpleJSON::Ptr_t WriteObject(const T &value)
+        {
+        BindingWriter writer;
+        Binding<T>::VisitFields(writer, value);
+        return writer.m_root;
+        }
+
+    BindingWriter(const BindingWriter&) = delete;
+    BindingWriter& operator=(const BindingWriter&) = delete;
+
+    template<typename U>
+    void Field(const char *name, size_t, const U &value)
+        { Write(name, value); }
+
+  private:
+    // creates a root object
+    BindingWriter();
+    // adds an array or object to the parent's container (named @c name if that's an object)
+    BindingWriter(BindingWriter &parent, const char *name, bool isArray);
+
+    void Write(const char *name, bool value);
+    void Write(const char *name, double value);
+    void Write(const char *name, const std::string &value);
+    void Write(const char *name, const wxString &value);
+    template<typename U>
+    typename std::enable_if<std::is_arithmetic<U>::value>::type
+    Write(const char *name, U value)
+        { Write(name, static_cast<double>(value)); }
+    template<typename U, typename A>
+    void Write(const char *name, const std::vector<U, A> &values)
+        {
+        BindingWriter array(*this, name, true);
+        for (const auto &value : values)
+            { array.Write(nullptr, value); }
+        }
+    template<typename U>
+    typename std::enable_if<std::is_class<U>::value>::type
+    Write(const char *name, const U &value)
+        {
+        BindingWriter object(*this, name, false);
+        Binding<U>::VisitFields(object, value);
+        }
+
+    // appends an item, with @c name as its (constant) key, deleting it on failure
+    bool Append(const char *name, cJSON *item);
+
+    wxSimpleJSON::Ptr_t m_root;
+    cJSON *m_node{ nullptr };
+    cJSON *m_tail{ nullptr };
+};
+
+template<typename T>
+inline bool wxSimpleJSON::View::To(T &value) const
+    { return BindingReader::ReadObject(m_d, value); }
+
+template<typename T>
+inline T wxSimpleJSON::View::To() const
+    {
+    T value{};
+    To(value);
+    return value;
+    }
+
+template<typename T>
+inline bool wxSimpleJSON::To(T &value) const
+    { return GetView().To(value); }
+
+template<typename T>
+inline T wxSimpleJSON::To() const
+    { return GetView().To<T>(); }
+
+template<typename T>
+inline wxSimpleJSON::Ptr_t wxSimpleJSON::From(const T &value)
+    { return BindingWriter::WriteObject(value); }
+
+/**
+ * @brief Declares the fields of a type for wxSimpleJSON::To() and wxSimpleJSON::From()
+ *      (see wxSimpleJSON::Binding). Use at global scope:
+ * @code
+ *  WX_SIMPLE_JSON_BIND_BEGIN(Resolution)
+ *      WX_SIMPLE_JSON_FIELD(width)
+ *      WX_SIMPLE_JSON_FIELD(height)
+ *  WX_SIMPLE_JSON_BIND_END()
+ *
+ *  WX_SIMPLE_JSON_BIND_BEGIN(Monitor)
+ *      WX_SIMPLE_JSON_FIELD_NAMED(m_name, "name")
+ *      WX_SIMPLE_JSON_FIELD_NAMED(m_resolutions, "resolutions")
+ *  WX_SIMPLE_JSON_BIND_END()
+ * @endcode
+ */
+#define WX_SIMPLE_JSON_BIND_BEGIN(Type)                                   \
+    template<>                                                            \
+    struct wxSimpleJSON::Binding<Type>                                    \
+    {                                                                     \
+        template<typename Visitor, typename Value>                        \
+        static void VisitFields(Visitor &visitor, Value &value)           \
+        {
+/// @brief Binds a field to the property called @c name (a UTF-8 string literal).
+#define WX_SIMPLE_JSON_FIELD_NAMED(member, name)                          \
+            visitor.Field(name, sizeof(name) - 1, value.member);
+/// @brief Binds a field to the property with the same name.
+#define WX_SIMPLE_JSON_FIELD(member)                                      \
+            WX_SIMPLE_JSON_FIELD_NAMED(member, #member)
+/// @brief Ends the fields started by WX_SIMPLE_JSON_BIND_BEGIN().
+#define WX_SIMPLE_JSON_BIND_END()                                         \
+        }                                                                 \
+    };
+
 #endif // WX_SIMPLE_JSON_H
@@ -0,0 +1,212 @@
+// Checks that documents survive being encoded as CBOR and decoded again.
+//
+// Text is parsed, encoded with WriteBinary(), decoded with CreateFromBinary()
+// and printed, which must give the same text as printing the parsed document.
+// Some encodings are also checked byte for byte, and malformed or truncated
+// data must be reported as an error. Returns EXIT_FAILURE if any check fails.
+
+#include "wxSimpleJSON.h"
+#include <wx/init.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+static size_t s_failures = 0;
+
+static void Check(bool passed, const char *what, const std::string &detail = std::string())
+{
+    if (!passed) {
+        fprintf(stderr, "FAILED: %s %s\n", what, detail.c_str());
+        ++s_failures;
+    }
+}
+
+static std::string Hex(const std::string &data)
+{
+    std::string text;
+    char byte[4]{ 0 };
+    for (const char c : data) {
+        snprintf(byte, sizeof(byte), "%02X ", static_cast<unsigned char>(c));
+        text += byte;
+    }
+    return text;
+}
+
+static wxSimpleJSON::Ptr_t Decode(const std::string &data)
+{
+    return wxSimpleJSON::CreateFromBinary(data.data(), data.length());
+}
+
+// Checks that text -> CBOR -> text gives the text the document prints as,
+// returning the encoding.
+static std::string CheckRoundTrip(const std::string &text)
+{
+    const auto parsed = wxSimpleJSON::CreateFromUTF8(text.data(), text.length(), true);
+    Check(parsed->IsOk(), "parse", text);
+    std::string encoded;
+    Check(parsed->WriteBinary(encoded), "encode", text);
+    const auto decoded = Decode(encoded);
+    Check(decoded->IsOk(), "decode", text + " from " + Hex(encoded));
+    Check(decoded->PrintUTF8(false) == parsed->PrintUTF8(false), "round trip",
+          text + " came back as " + decoded->PrintUTF8(false));
+    // arena documents are encoded and decoded the same way
+    wxSimpleJSON::ParseOptions arena;
+    arena.useArena = true;
+    std::string reencoded;
+    const auto decodedIntoArena = wxSimpleJSON::CreateFromBinary(encoded.data(), encoded.length(), arena);
+    Check(decodedIntoArena->WriteBinary(reencoded) && reencoded == encoded, "re-encode", text);
+    return encoded;
+}
+
+static void CheckEncoding(const std::string &text, const std::string &expected)
+{
+    const std::string encoded = CheckRoundTrip(text);
+    Check(encoded == expected, "encoding", text + " is " + Hex(encoded));
+}
+
+static void CheckRejected(const std::string &data, const char *what)
+{
+    const auto decoded = Decode(data);
+    Check(!decoded->IsOk() && !decoded->GetLastError().IsEmpty(), what, Hex(data));
+}
+
+static void CheckTypes()
+{
+    CheckEncoding("null", std::string("\xF6", 1));
+    CheckEncoding("true", std::string("\xF5", 1));
+    CheckEncoding("false", std::string("\xF4", 1));
+    CheckEncoding("\"\"", std::string("\x60", 1));
+    CheckEncoding("[]", std::string("\x80", 1));
+    CheckEncoding("{}", std::string("\xA0", 1));
+    CheckEncoding("{\"a\":[1,\"b\"]}", std::string("\xA1\x61" "a" "\x82\x01\x61" "b", 7));
+    CheckRoundTrip("{\"null\":null,\"true\":true,\"false\":false,\"number\":-12.25,"
+                   "\"string\":\"text with \\\"quotes\\\", \\\\ and \\n\",\"empty\":{},"
+                   "\"array\":[[],[[1,[2,[3,{\"deep\":[null,{}]}]]]],{\"a\":{\"b\":{\"c\":[true]}}}],"
+                   "\"duplicate\":1,\"duplicate\":2}");
+
+    // a container with more items than fit in the head's byte
+    std::string large{ "[" };
+    for (int i = 0; i < 70000; ++i) {
+        large += (i > 0) ? ",\"" : "\"";
+        large += std::to_string(i) + "\"";
+    }
+    large += "]";
+    CheckRoundTrip(large);
+}
+
+static void CheckStrings()
+{
+    CheckEncoding("\"\\u00e9\"", std::string("\x62\xC3\xA9", 3));
+    CheckRoundTrip("{\"caf\\u00e9\":\"cr\\u00e8me br\\u00fbl\\u00e9e\",\"\xE6\x97\xA5\xE6\x9C\xAC\":"
+                   "[\"\xE8\xAA\x9E\",\"\\ud83d\\ude00 \xF0\x9F\x98\x80\",\"\\u007f\\u0080\\u07ff\\u0800\\uffff\"]}");
+    // a string longer than 255 bytes, of multi-byte characters
+    std::string longText{ "\"" };
+    for (int i = 0; i < 300; ++i) {
+        longText += "\xE2\x9C\x93";
+    }
+    longText += "\"";
+    const std::string encoded = CheckRoundTrip(longText);
+    Check(encoded.compare(0, 3, std::string("\x79\x03\x84", 3)) == 0, "string length", Hex(encoded.substr(0, 3)));
+}
+
+static void CheckNumbers()
+{
+    // whole numbers are written as integers, in as few bytes as possible
+    CheckEncoding("0", std::string("\x00", 1));
+    CheckEncoding("23", std::string("\x17", 1));
+    CheckEncoding("24", std::string("\x18\x18", 2));
+    CheckEncoding("-1", std::string("\x20", 1));
+    CheckEncoding("-25", std::string("\x38\x18", 2));
+    CheckEncoding("65536", std::string("\x1A\x00\x01\x00\x00", 5));
+    CheckEncoding("1e3", std::string("\x19\x03\xE8", 3));
+    CheckEncoding("9007199254740992", std::string("\x1B\x00\x20\x00\x00\x00\x00\x00\x00", 9));
+    CheckEncoding("-9007199254740992", std::string("\x3B\x00\x1F\xFF\xFF\xFF\xFF\xFF\xFF", 9));
+    CheckRoundTrip("[9007199254740991,-9007199254740991,9007199254740993,9007199254740994,"
+                   "-9007199254740994,9223372036854775807,-9223372036854775808,"
+                   "18446744073709551615,-18446744073709551616,1e300,-1e-300,5e-324]");
+    // others as the smallest float that holds them exactly
+    CheckEncoding("1.5", std::string("\xFA\x3F\xC0\x00\x00", 5));
+    CheckEncoding("0.1", std::string("\xFB\x3F\xB9\x99\x99\x99\x99\x99\x9A", 9));
+    CheckEncoding("-0.0", std::string("\xFA\x80\x00\x00\x00", 5));
+    CheckRoundTrip("[0.5,-0.0,0.30000000000000004,1.7976931348623157e308,2.2250738585072014e-308,"
+                   "4503599627370495.5,1.0000000000000002,3.4028234663852886e38,1.401298464324817e-45]");
+
+    const auto zero = Decode(std::string("\xFA\x80\x00\x00\x00", 5));
+    Check(zero->GetValueNumber() == 0 && std::signbit(zero->GetValueNumber()), "negative zero");
+    const auto half = Decode(std::string("\xF9\x3E\x00", 3));
+    Check(half->GetValueNumber() == 1.5, "half precision");
+
+    // JSON has no NaN or infinities: they are written as null, and can't be read
+    auto special = wxSimpleJSON::Create(wxSimpleJSON::IS_OBJECT, true);
+    special->Add("nan", std::nan("")).Add("infinity", HUGE_VAL).Add("-infinity", -HUGE_VAL);
+    std::string encoded;
+    Check(special->WriteBinary(encoded), "encode NaN");
+    Check(Decode(encoded)->PrintUTF8(false) == special->PrintUTF8(false), "NaN as null",
+          Decode(encoded)->PrintUTF8(false));
+    CheckRejected(std::string("\xF9\x7E\x00", 3), "half precision NaN");
+    CheckRejected(std::string("\xF9\xFC\x00", 3), "half precision -infinity");
+    CheckRejected(std::string("\xFA\x7F\x80\x00\x00", 5), "single precision infinity");
+    CheckRejected(std::string("\xFA\x7F\xC0\x00\x00", 5), "single precision NaN");
+    CheckRejected(std::string("\xFB\x7F\xF8\x00\x00\x00\x00\x00\x00", 9), "double precision NaN");
+    CheckRejected(std::string("\x81\xFB\xFF\xF0\x00\x00\x00\x00\x00\x00", 10), "nested -infinity");
+}
+
+static void CheckRaw()
+{
+    // embedded JSON (tag 262) is read as raw JSON, printed as is and written back the same way
+    const std::string raw("\xD9\x01\x06\x6B{\"a\":[1,2]}", 15);
+    const std::string wrapped = std::string("\xA1\x61" "r", 3) + raw;
+    const auto decoded = Decode(wrapped);
+    Check(decoded->IsOk(), "decode raw", Hex(wrapped));
+    Check(decoded->GetProperty("r")->GetType() == wxSimpleJSON::IS_RAW, "raw type");
+    Check(decoded->PrintUTF8(false) == "{\"r\":{\"a\":[1,2]}}", "print raw", decoded->PrintUTF8(false));
+    std::string encoded;
+    Check(decoded->WriteBinary(encoded) && encoded == wrapped, "encode raw", Hex(encoded));
+    // the text printed for a raw node reads back as the same JSON
+    CheckRoundTrip(decoded->PrintUTF8(false));
+    CheckRejected(std::string("\xD9\x01\x06\x01", 4), "tag 262 without text");
+    // other tags are skipped
+    Check(Decode(std::string("\xC1\x1A\x5F\x00\x00\x00", 6))->GetValueNumber() == 1593835520.0, "other tag");
+}
+
+static void CheckTruncated()
+{
+    const std::string encoded = CheckRoundTrip(
+        "{\"caf\\u00e9\":[1,-300,70000,4294967296,1.5,0.1,\"text\",null,true,false,"
+        "{\"nested\":[[],{}]},\"\\ud83d\\ude00\"],\"last\":\"value\"}");
+    for (size_t length = 0; length < encoded.length(); ++length) {
+        CheckRejected(encoded.substr(0, length), "truncated");
+    }
+    // trailing data, indefinite lengths without a break and other malformed data
+    CheckRejected(encoded + std::string("\x00", 1), "trailing byte");
+    CheckRejected(std::string("\x9F\x01\x02", 3), "array without a break");
+    CheckRejected(std::string("\xBF\x61" "a" "\x01", 4), "map without a break");
+    CheckRejected(std::string("\xA1\x01\x02", 3), "map key that isn't text");
+    CheckRejected(std::string("\x42\x01\x02", 3), "byte string");
+    CheckRejected(std::string("\x62\xC3", 2), "string shorter than its length");
+    CheckRejected(std::string("\x9B\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF", 9), "huge array");
+    Check(Decode(std::string("\x9F\x01\x02\xFF", 4))->PrintUTF8(false) == "[1,2]", "indefinite array");
+}
+
+int main()
+{
+    wxInitializer initializer;
+    if (!initializer.IsOk()) {
+        fprintf(stderr, "Failed to initialize wxWidgets.\n");
+        return EXIT_FAILURE;
+    }
+
+    CheckTypes();
+    CheckStrings();
+    CheckNumbers();
+    CheckRaw();
+    CheckTruncated();
+
+    if (s_failures != 0) {
+        fprintf(stderr, "%zu CBOR checks failed.\n", s_failures);
+        return EXIT_FAILURE;
+    }
+    printf("All CBOR checks passed.\n");
+    return EXIT_SUCCESS;
+}
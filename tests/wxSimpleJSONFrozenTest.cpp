@@ -0,0 +1,126 @@
+// Checks that a frozen document can be read from many threads at once.
+//
+// Every thread looks values up, iterates through arrays and objects and prints
+// subtrees of one frozen document, comparing each result with the one read on
+// the main thread beforehand, while handles into the document are copied and
+// dropped on every thread. Returns EXIT_FAILURE if any result differs.
+//
+// Build with -DSIMPLEJSON_SANITIZE=thread to also have ThreadSanitizer check
+// the reads for data races.
+
+#include "wxSimpleJSON.h"
+#include <wx/init.h>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const size_t RecordCount = 500;
+static const unsigned int ReaderThreads = 16;
+static const size_t ReadsPerThread = 2000;
+
+// What a record read through a handle should look like.
+struct Expected
+{
+    std::string m_name;
+    std::string m_text;
+    std::string m_child;
+    double m_valueSum{ 0 };
+    size_t m_keyCount{ 0 };
+};
+
+static std::string MakeDocument()
+{
+    std::string text{ "[" };
+    for (size_t i = 0; i < RecordCount; ++i) {
+        const std::string id = std::to_string(i);
+        if (i > 0) {
+            text += ",";
+        }
+        text += "{\"id\":" + id + ",\"name\":\"r\\u00e9cord " + id + "\",";
+        text += "\"flag\":" + std::string((i % 2) ? "true" : "false") + ",\"none\":null,";
+        text += "\"values\":[" + id + ",0.5,-" + id + "e-1],\"tags\":[\"a\",\"b\\n\"],";
+        text += "\"nested\":{\"depth\":" + id + ",\"child\":{\"leaf\":[[],{},\"" + id + "\"]}}}";
+    }
+    text += "]";
+    return text;
+}
+
+static Expected Read(const wxSimpleJSON::FrozenNode &record)
+{
+    Expected read;
+    const wxSimpleJSON::View view = record.GetView();
+    const wxSimpleJSON::UTF8View name = view.GetProperty("name").GetValueStringUTF8();
+    read.m_name.assign(name.data(), name.length());
+    read.m_text = record.PrintUTF8(false);
+    read.m_child = record.At("/nested/child").PrintUTF8(true);
+    for (const wxSimpleJSON::View value : view.GetProperty("values")) {
+        read.m_valueSum += value.GetValueNumber();
+    }
+    for (const wxSimpleJSON::View property : view) {
+        read.m_keyCount += property.GetNameUTF8().empty() ? 0 : 1;
+    }
+    return read;
+}
+
+static bool Matches(const Expected &read, const Expected &expected)
+{
+    return (read.m_name == expected.m_name && read.m_text == expected.m_text &&
+            read.m_child == expected.m_child && read.m_valueSum == expected.m_valueSum &&
+            read.m_keyCount == expected.m_keyCount);
+}
+
+int main()
+{
+    wxInitializer initializer;
+    if (!initializer.IsOk()) {
+        fprintf(stderr, "Failed to initialize wxWidgets.\n");
+        return EXIT_FAILURE;
+    }
+
+    const std::string text = MakeDocument();
+    const wxSimpleJSON::FrozenNode frozen =
+        wxSimpleJSON::CreateFromUTF8(text.data(), text.length(), true)->Freeze();
+    if (frozen.ArraySize() != RecordCount) {
+        fprintf(stderr, "Failed to parse and freeze the document.\n");
+        return EXIT_FAILURE;
+    }
+    std::vector<Expected> expected;
+    for (size_t i = 0; i < RecordCount; ++i) {
+        expected.push_back(Read(frozen.Item(i)));
+    }
+
+    std::atomic<size_t> failures{ 0 };
+    std::vector<std::thread> readers;
+    for (unsigned int reader = 0; reader < ReaderThreads; ++reader) {
+        readers.emplace_back([&, reader]()
+            {
+            for (size_t i = 0; i < ReadsPerThread; ++i) {
+                const size_t index = (reader * 37 + i * 11) % RecordCount;
+                const wxSimpleJSON::FrozenNode record = frozen.Item(index);
+                const wxSimpleJSON::FrozenNode id = record.GetProperty("ID");
+                const wxSimpleJSON::FrozenNode flag = record.GetProperty("flag", true);
+                if (id.GetView().GetValueNumber() != static_cast<double>(index) ||
+                    flag.GetView().GetValueBool() != ((index % 2) != 0) ||
+                    record.GetProperty("none").GetType() != wxSimpleJSON::IS_NULL ||
+                    record.GetProperty("tags").ArraySize() != 2 ||
+                    !Matches(Read(record), expected[index])) {
+                    ++failures;
+                }
+            }
+            });
+    }
+    for (auto &reader : readers) {
+        reader.join();
+    }
+
+    if (failures != 0) {
+        fprintf(stderr, "%zu of %zu reads of the frozen document differed.\n",
+                failures.load(), static_cast<size_t>(ReaderThreads) * ReadsPerThread);
+        return EXIT_FAILURE;
+    }
+    printf("%u threads read the frozen document %zu times each.\n", ReaderThreads, ReadsPerThread);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,134 @@
+// Checks that lazily parsed documents read the same as eagerly parsed ones.
+//
+// Each text is parsed eagerly and lazily (copying and borrowing the text).
+// Valid text must print the same either way, after every node of the lazy
+// document was reached through views. Text that the eager parser rejects must
+// fail to load lazily or have a malformed value that reads as an invalid node.
+// Returns EXIT_FAILURE if any check fails.
+
+#include "wxSimpleJSON.h"
+#include <wx/init.h>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+static size_t s_failures = 0;
+
+static void Check(bool passed, const char *what, const std::string &detail = std::string())
+{
+    if (!passed) {
+        fprintf(stderr, "FAILED: %s %s\n", what, detail.c_str());
+        ++s_failures;
+    }
+}
+
+// Reaches every node under view (parsing each level of a lazy document),
+// returning how many of them are invalid.
+static size_t CountInvalid(const wxSimpleJSON::View view)
+{
+    if (view.GetType() == wxSimpleJSON::IS_INVALID) {
+        return 1;
+    }
+    size_t invalid = 0;
+    if (view.IsValueArray() || view.IsValueObject()) {
+        for (const wxSimpleJSON::View child : view) {
+            invalid += CountInvalid(child);
+        }
+    }
+    return invalid;
+}
+
+static wxSimpleJSON::Ptr_t ParseLazily(const std::string &text, bool borrowText)
+{
+    wxSimpleJSON::ParseOptions options;
+    options.lazy = true;
+    options.borrowText = borrowText;
+    return wxSimpleJSON::CreateFromUTF8(text.data(), text.length(), options);
+}
+
+// Checks that text reads the same lazily as it does eagerly.
+static void CheckSame(const std::string &text)
+{
+    const auto eager = wxSimpleJSON::CreateFromUTF8(text.data(), text.length(), true);
+    for (const bool borrowText : { false, true }) {
+        const auto lazy = ParseLazily(text, borrowText);
+        if (eager->IsOk()) {
+            Check(lazy->IsOk() && CountInvalid(lazy->GetView()) == 0, "lazy parse", text);
+            Check(lazy->PrintUTF8(false) == eager->PrintUTF8(false), "lazy print",
+                  text + " printed as " + lazy->PrintUTF8(false));
+        }
+        else {
+            Check(!lazy->IsOk() || CountInvalid(lazy->GetView()) != 0, "malformed lazy text", text);
+        }
+    }
+}
+
+static void CheckValid()
+{
+    CheckSame("{}");
+    CheckSame("[]");
+    CheckSame(" [ [ ] , { } ] ");
+    CheckSame("{\"a\":[1,{\"b\":[]}],\"c\":{\"d\":\"e\"},\"f\":null}");
+    CheckSame("{ \"a\" : [ 1 ]  , \"b\" :\t{ \"c\" : [ [ 2 ] ] }\n}");
+    CheckSame("[[1],[2,[3,[4,[5,{\"deep\":[true,false]}]]]]]");
+    // brackets, commas and escaped quotes inside strings
+    CheckSame("{\"a\":\"]},[{\",\"b\":[\"[\\\"]\",\"\\\\\"],\"c\":{\"}\":\"{\"}}");
+    CheckSame("{\"caf\\u00e9\":[\"\\ud83d\\ude00\",\"\xE6\x97\xA5\"],\"x\":{\"\\n\":1e3}}");
+}
+
+static void CheckTrailingJunk()
+{
+    // junk after a nested container: the property reads as invalid
+    for (const char *text : { "{\"a\":[1] 2}", "{\"a\":[1] [2]}", "{\"a\":{\"b\":1} \"c\"}",
+                              "{\"a\":[1]x,\"b\":2}" }) {
+        const auto lazy = ParseLazily(text, false);
+        if (lazy->IsOk()) {
+            Check(lazy->GetView().GetProperty("a").GetType() == wxSimpleJSON::IS_INVALID,
+                  "junk after a container", text);
+        }
+        CheckSame(text);
+    }
+    CheckSame("[[1] 2]");
+    CheckSame("[[1] [2]]");
+    CheckSame("[{\"a\":1}{\"b\":2}]");
+    CheckSame("{\"a\":[[1] 2]}");
+    CheckSame("{\"a\":[{\"b\":[1] null}]}");
+    CheckSame("[[1],[2] ,[3]\"x\"]");
+    // and after the document itself
+    CheckSame("[1] 2");
+    CheckSame("{\"a\":[1]} {}");
+    // whitespace is fine
+    CheckSame("{\"a\":[1] \t\r\n ,\"b\":{} }");
+}
+
+static void CheckMalformed()
+{
+    CheckSame("{\"a\":[1,]}");
+    CheckSame("{\"a\":[1 2]}");
+    CheckSame("{\"a\":{\"b\"}}");
+    CheckSame("{\"a\":{\"b\":}}");
+    CheckSame("[[\"unterminated]]");
+    CheckSame("[[1]");
+    CheckSame("[[1]]]");
+    CheckSame("{\"a\":[1}]");
+}
+
+int main()
+{
+    wxInitializer initializer;
+    if (!initializer.IsOk()) {
+        fprintf(stderr, "Failed to initialize wxWidgets.\n");
+        return EXIT_FAILURE;
+    }
+
+    CheckValid();
+    CheckTrailingJunk();
+    CheckMalformed();
+
+    if (s_failures != 0) {
+        fprintf(stderr, "%zu lazy parsing checks failed.\n", s_failures);
+        return EXIT_FAILURE;
+    }
+    printf("All lazy parsing checks passed.\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,113 @@
+// Checks that reused records and documents read and print as freshly parsed ones.
+//
+// NDJSONReader (with reuseNodes) and Document recycle the root's handle and the
+// arena of the previous record, so the next record's nodes are often allocated
+// at the same addresses. Nothing from the previous record (its print cache,
+// property index or error) may carry over. Returns EXIT_FAILURE if any check fails.
+
+#include "wxSimpleJSON.h"
+#include <wx/init.h>
+#include <wx/mstream.h>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+static size_t s_failures = 0;
+
+static void Check(bool passed, const char *what, const std::string &detail = std::string())
+{
+    if (!passed) {
+        fprintf(stderr, "FAILED: %s %s\n", what, detail.c_str());
+        ++s_failures;
+    }
+}
+
+// Records of the same shape, so that each one's nodes take the previous one's places.
+static const std::vector<std::string> Records{
+    "{\"id\":1,\"tags\":[\"a\",\"b\"],\"user\":{\"name\":\"first\"}}",
+    "{\"id\":2,\"tags\":[\"c\",\"d\"],\"user\":{\"name\":\"second\"}}",
+    "not json",
+    "{\"id\":3,\"tags\":[\"e\",\"f\"],\"user\":{\"name\":\"third\"}}",
+    "{\"ID\":4}"
+};
+
+static std::string JoinRecords()
+{
+    std::string text;
+    for (const auto &record : Records) {
+        text += record + "\n";
+    }
+    return text;
+}
+
+// Reads every record, with the print cache enabled on the ones selected by cacheRecord.
+static void CheckReader(bool (*cacheRecord)(size_t))
+{
+    const std::string text = JoinRecords();
+    wxMemoryInputStream stream(text.data(), text.length());
+    wxSimpleJSON::NDJSONReader reader(stream);
+    wxSimpleJSON::Ptr_t record;
+    size_t index = 0;
+    for (; reader.Next(record); ++index) {
+        if (index >= Records.size()) {
+            break;
+        }
+        const std::string &expected = Records[index];
+        if (expected == "not json") {
+            Check(!record->IsOk() && !record->GetLastError().IsEmpty(), "malformed record");
+            continue;
+        }
+        Check(record->IsOk() && record->GetLastError().IsEmpty(), "record", expected);
+        if (cacheRecord(index)) {
+            record->EnablePrintCache();
+        }
+        // printed twice, the second time from the cache (if enabled)
+        Check(record->PrintUTF8(false) == expected, "print", expected + " printed as " + record->PrintUTF8(false));
+        Check(record->PrintUTF8(false) == expected, "print again", expected);
+        Check(record->GetProperty("user")->PrintUTF8(false) ==
+              wxSimpleJSON::CreateFromUTF8(expected.data(), expected.length(), true)->GetProperty("user")->PrintUTF8(false),
+              "print a child", expected);
+        // the property index is rebuilt for each record
+        Check(record->GetProperty("id", true)->IsOk() == (expected.find("\"id\"") != std::string::npos),
+              "property index", expected);
+    }
+    Check(index == Records.size(), "record count");
+}
+
+static void CheckDocument()
+{
+    wxSimpleJSON::Document document;
+    for (const auto &expected : Records) {
+        const auto root = document.Parse(expected.data(), expected.length());
+        if (expected == "not json") {
+            Check(!root->IsOk() && !root->GetLastError().IsEmpty(), "malformed document");
+            continue;
+        }
+        Check(root->IsOk() && root->GetLastError().IsEmpty(), "document", expected);
+        root->EnablePrintCache();
+        Check(root->PrintUTF8(false) == expected, "print document",
+              expected + " printed as " + root->PrintUTF8(false));
+    }
+}
+
+int main()
+{
+    wxInitializer initializer;
+    if (!initializer.IsOk()) {
+        fprintf(stderr, "Failed to initialize wxWidgets.\n");
+        return EXIT_FAILURE;
+    }
+
+    CheckReader([](size_t) { return true; });
+    CheckReader([](size_t index) { return index == 0; });
+    CheckReader([](size_t) { return false; });
+    CheckDocument();
+
+    if (s_failures != 0) {
+        fprintf(stderr, "%zu record reuse checks failed.\n", s_failures);
+        return EXIT_FAILURE;
+    }
+    printf("All record reuse checks passed.\n");
+    return EXIT_SUCCESS;
+}
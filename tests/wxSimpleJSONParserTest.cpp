@@ -0,0 +1,309 @@
+// Checks that the library's parser reads text the same way as cJSON.
+//
+// Each text in the corpus is parsed with cJSON_ParseWithLengthOpts(), followed
+// by the end-of-input rule the library applies (only whitespace may follow the
+// value, and a null character ends the text), and with CreateFromUTF8(). The
+// trees must be identical (down to the bits of each number), and a failed parse
+// must report the same line and column. Each text is also parsed as an item of
+// an array big enough to be split between threads (see ParseOptions::threads),
+// which must read the same as a serial parse, error messages included.
+// Returns EXIT_FAILURE if any check fails.
+
+#include "wxSimpleJSON.h"
+#include "cJSON/cJSON.h"
+#include <wx/init.h>
+#include <wx/numformatter.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static size_t s_failures = 0;
+
+static void Check(bool passed, const char *what, const std::string &detail = std::string())
+{
+    if (!passed) {
+        fprintf(stderr, "FAILED: %s %s\n", what, detail.c_str());
+        ++s_failures;
+    }
+}
+
+// Shows control characters and non-ASCII bytes as escapes, and shortens long texts.
+static std::string Describe(const std::string &text)
+{
+    std::string shown;
+    char escaped[8]{ 0 };
+    for (const char c : text.substr(0, 200)) {
+        if (static_cast<unsigned char>(c) < 32 || static_cast<unsigned char>(c) > 126) {
+            snprintf(escaped, sizeof(escaped), "<%02X>", static_cast<unsigned char>(c));
+            shown += escaped;
+        }
+        else {
+            shown += c;
+        }
+    }
+    return (text.length() > 200) ? shown + "... (" + std::to_string(text.length()) + " bytes)" : shown;
+}
+
+// Text that can contain null characters.
+template<size_t N>
+static std::string Text(const char (&text)[N])
+{
+    return std::string(text, N - 1);
+}
+
+static std::string ToString(const wxSimpleJSON::UTF8View &view)
+{
+    return std::string(view.data(), view.length());
+}
+
+static bool SameTree(const cJSON *expected, const wxSimpleJSON::View actual)
+{
+    if (static_cast<int>(actual.GetType()) != (expected->type & 0xFF)) {
+        return false;
+    }
+    if (expected->string != nullptr && ToString(actual.GetNameUTF8()) != expected->string) {
+        return false;
+    }
+    switch (actual.GetType()) {
+        case wxSimpleJSON::IS_NUMBER:
+            {
+            const double number = actual.GetValueNumber();
+            return (memcmp(&number, &expected->valuedouble, sizeof(double)) == 0);
+            }
+        case wxSimpleJSON::IS_STRING:
+            return (ToString(actual.GetValueStringUTF8()) == expected->valuestring);
+        case wxSimpleJSON::IS_ARRAY:
+        case wxSimpleJSON::IS_OBJECT:
+            {
+            const cJSON *child = expected->child;
+            for (const wxSimpleJSON::View item : actual) {
+                if (child == nullptr || !SameTree(child, item)) {
+                    return false;
+                }
+                child = child->next;
+            }
+            return (child == nullptr);
+            }
+        default:
+            return true;
+    }
+}
+
+// Parses text the way the library did before it had a parser of its own.
+static cJSON *ParseWithCJSON(const std::string &text, const char *&parseEnd)
+{
+    const char *end = text.data() + text.length();
+    cJSON *parsed = cJSON_ParseWithLengthOpts(text.data(), text.length(), &parseEnd, false);
+    if (parsed != nullptr) {
+        const char *trailing = parseEnd;
+        while (trailing < end && *trailing != 0 && static_cast<unsigned char>(*trailing) <= 32) {
+            ++trailing;
+        }
+        if (trailing < end && *trailing != 0) {
+            cJSON_Delete(parsed);
+            parsed = nullptr;
+            parseEnd = trailing;
+        }
+    }
+    return parsed;
+}
+
+// The start of the error message for a parse that stopped at parseEnd.
+static wxString DescribeErrorPosition(const std::string &text, const char *parseEnd)
+{
+    const char *lineStart = text.data();
+    size_t line = 0;
+    for (const char *p = text.data(); p < parseEnd; ++p) {
+        if (*p == '\n') {
+            ++line;
+            lineStart = p + 1;
+        }
+    }
+    return wxString::Format(L"JSON parsing error at line %s, column %s.",
+        wxNumberFormatter::ToString(static_cast<long>(line) + 1, 0,
+                                    wxNumberFormatter::Style::Style_WithThousandsSep),
+        wxNumberFormatter::ToString(static_cast<long>(parseEnd - lineStart) + 1, 0,
+                                    wxNumberFormatter::Style::Style_WithThousandsSep));
+}
+
+static void CheckText(const std::string &text)
+{
+    const char *parseEnd{ nullptr };
+    cJSON *expected = ParseWithCJSON(text, parseEnd);
+    const auto parsed = wxSimpleJSON::CreateFromUTF8(text.data(), text.length(), true);
+    if (expected != nullptr) {
+        Check(parsed->IsOk(), "parse", Describe(text) + ": " + parsed->GetLastError().ToStdString());
+        Check(!parsed->IsOk() || SameTree(expected, parsed->GetView()), "tree",
+              Describe(text) + " read as " + Describe(parsed->PrintUTF8(false)));
+        cJSON_Delete(expected);
+    }
+    else {
+        const wxString position = DescribeErrorPosition(text, parseEnd);
+        Check(!parsed->IsOk(), "malformed text", Describe(text));
+        Check(parsed->IsOk() || parsed->GetLastError().StartsWith(position), "error position",
+              Describe(text) + ": expected " + position.ToStdString() + " got " +
+              parsed->GetLastError().BeforeFirst(L'\n').ToStdString());
+    }
+}
+
+// Elements that make an array big enough to be parsed on several threads.
+static std::string MakeFiller()
+{
+    std::string filler;
+    for (size_t i = 0; filler.length() < 320 * 1024; ++i) {
+        filler += "{\"id\":" + std::to_string(i) + ",\"values\":[1.5,-2e3,\"text\",null,true]},\n";
+    }
+    return filler;
+}
+
+// Checks that text parses the same with threads as without, in the middle and at the end of an array.
+static void CheckParallel(const std::string &item)
+{
+    static const std::string filler = MakeFiller();
+    wxSimpleJSON::ParseOptions threads;
+    threads.threads = 4;
+    for (const std::string &text : { "[" + filler + item + ",\n" + filler + "0]",
+                                     "[" + filler + item + "]" }) {
+        const auto serial = wxSimpleJSON::CreateFromUTF8(text.data(), text.length(), true);
+        const auto parallel = wxSimpleJSON::CreateFromUTF8(text.data(), text.length(), threads);
+        Check(parallel->IsOk() == serial->IsOk(), "parallel parse", Describe(item));
+        Check(parallel->GetLastError() == serial->GetLastError(), "parallel error", Describe(item) + ": " +
+              parallel->GetLastError().BeforeFirst(L'\n').ToStdString() + " instead of " +
+              serial->GetLastError().BeforeFirst(L'\n').ToStdString());
+        Check(!serial->IsOk() || parallel->PrintUTF8(false) == serial->PrintUTF8(false), "parallel tree",
+              Describe(item));
+    }
+}
+
+static std::vector<std::string> MakeCorpus()
+{
+    std::vector<std::string> corpus{
+        // literals and structure
+        "null", "true", "false", "nul", "tru", "nulll", "True", "", " ", "\t\r\n ",
+        "[]", "{}", "[ ]", "{ }", "[1,2,3]", "[[],[[]],{}]", "{\"a\":1,\"b\":[true,false,null],\"c\":{}}",
+        "{\"a\":1,\"a\":2}", "[1,]", "[,1]", "[1 2]", "[1,,2]", "{\"a\"}", "{\"a\":}", "{\"a\":1,}",
+        "{1:2}", "{\"a\" 1}", "[", "]", "{", "}", "[1", "{\"a\":1", "[1}", "{\"a\":1]",
+        "\n[1,\n 2,,\n 3]", "{\n  \"a\": [\n    1,\n    x\n  ]\n}", "[1] 2", "[1]x", "1 2", "\"a\" \"b\"",
+        // whitespace, including control characters that cJSON skips
+        " \t\r\n[ 1 , 2 ]\n\t ", "\x01[\x1F""1\x7F]", "[1]\x01", "\x7F[1]",
+        // null characters between tokens, inside strings and after the text, and a BOM
+        Text("\0"), Text("\0[1]"), Text("[1]\0"), Text("[1]\0junk"), Text("[1]  \0  junk"), Text("[1,\0 2]"), Text("[\0]"), Text("{\"a\":\0 1}"),
+        Text("[\"a\0b\"]"), Text("{\"a\0b\":\"c\0d\"}"), Text("1\0"), Text("\"text\"\0\0"), Text("tr\0ue"), Text("[1\0 2]"),
+        "\xEF\xBB\xBF[1]", "\xEF\xBB\xBF" "1", "\xEF\xBB\xBF" "12", "\xEF\xBB\xBF", "[\xEF\xBB\xBF" "1]",
+        "\xEF\xBB\xBF\xEF\xBB\xBF[1]", "\xEF\xBB[1]",
+        // escapes, surrogate pairs and lone surrogates
+        "\"\\b\\f\\n\\r\\t\\\"\\\\\\/\"", "\"\\x\"", "\"\\'\"", "\"\\\"", "\"\\", "\"abc", "\"abc\\\"",
+        "\"\\u00e9\\u00E9\\u0041\\u07ff\\u0800\\uffff\"", "\"\\u0000\"", "\"a\\u0000b\"", "\"\\u12\"",
+        "\"\\u123\"", "\"\\uZZZZ\"", "\"\\u00g0\"", "\"\\ud83d\\ude00\"", "\"\\uD83D\\uDE00\\uDBFF\\uDFFF\"",
+        "\"\\ud800\\udc00\"", "\"\\ud83d\"", "\"\\ud83d \"", "\"\\ud83dabcdef\"", "\"\\ud83d\\u0041\"",
+        "\"\\ud83d\\ud83d\"", "\"\\ude00\"", "\"\\ude00\\ud83d\"", "\"\\ud83d\\ude0\"", "\"\\ud83d\\\"",
+        "\"a\tb\nc\rd\"", "\"\x01\x1F\x7F\"", "\"\xC3\xA9\xE6\x97\xA5\xF0\x9F\x98\x80\"", "\"\xFF\xFE\x80\"",
+        "{\"\\u00e9\":1,\"a\\\"b\":2,\"\\ud83d\\ude00\":3,\"\":4}", "{\"\\ud83d\":1}", "{\"a\\q\":1}",
+        // numbers, especially at the edges of the fast path
+        "0", "-0", "-0.0", "0.0", "0e0", "-0e-0", "1E+2", "1e-2", "1E22", "1.5", "-1.5", "123.456e-10",
+        "01", "-01", "00", "1.", "-1.", ".5", "-.5", "+1", "-", "--1", "1e", "1e+", "1E-", "1.e3",
+        "0x10", "1.5e3.2", "1-2", "1e5e5", "1.2.3", "Infinity", "-Infinity", "NaN",
+        "999999999999999999", "1234567890123456789", "9999999999999999999", "12345678901234567890",
+        "-1234567890123456789", "-12345678901234567890", "9007199254740991", "9007199254740992",
+        "9007199254740993", "18446744073709551615", "18446744073709551616", "-9223372036854775808",
+        "1e22", "1e23", "1e-22", "1e-23", "9007199254740991e22", "9007199254740991e23",
+        "9007199254740991e-22", "9007199254740991e-23", "9007199254740993e22", "1.5e22", "15e21",
+        "123456789e-22", "123456789e-23", "1234567890123456789e22", "1234567890123456789e-22",
+        "12345678901234567890e-23", "0.1", "0.2", "0.3", "0.30000000000000004", "3.141592653589793",
+        "1.7976931348623157e308", "1.7976931348623159e308", "1e308", "1e309", "1e400", "-1e400",
+        "2.2250738585072014e-308", "2.2250738585072011e-308", "2.225073858507201e-308", "4.9e-324",
+        "5e-324", "2.4703282292062327e-324", "2.4703282292062328e-324", "1e-324", "1e-400", "-1e-400",
+        "0.000001", "1e-7", "100000000000000000000000", "1.00000000000000011102230246251565404236316680908203125",
+        "[1,2.5,-3e2,0,-0,1e22,1e23,12345678901234567890]", "{\"a\":1e5000,\"b\":-1e-5000}",
+        std::string("1") + std::string(62, '0'), std::string("1") + std::string(63, '0'),
+        std::string("1") + std::string(70, '0'), "0." + std::string(70, '0') + "1",
+        "1." + std::string(61, '5'), "[" + std::string(64, '9') + "]"
+    };
+
+    // the nesting limit
+    for (const size_t depth : { 999, 1000, 1001 }) {
+        corpus.push_back(std::string(depth, '[') + std::string(depth, ']'));
+        std::string objects;
+        for (size_t i = 0; i < depth; ++i) {
+            objects += "{\"a\":";
+        }
+        corpus.push_back(objects + "1" + std::string(depth, '}'));
+        std::string mixed;
+        for (size_t i = 0; i < depth; ++i) {
+            mixed += (i % 2) ? "{\"a\":" : "[";
+        }
+        mixed += "null";
+        for (size_t i = depth; i > 0; --i) {
+            mixed += ((i - 1) % 2) ? "}" : "]";
+        }
+        corpus.push_back(mixed);
+    }
+    return corpus;
+}
+
+// Texts longer than the parser's 16 and 32 byte blocks, with escapes, quotes,
+// null characters and whitespace at and across the blocks' boundaries.
+static std::vector<std::string> MakeBlockCorpus()
+{
+    std::vector<std::string> corpus;
+    const std::vector<std::string> inserts{ "\\\"", "\\\\", "\\u00e9", "\\ud83d\\ude00", "\\n", "\xC3\xA9",
+                                            "\\ud83d", "\\q", Text("\0"), "\x1F" };
+    for (const size_t length : { 14, 15, 16, 17, 30, 31, 32, 33, 47, 48, 63, 64, 65, 95, 96, 97 }) {
+        for (size_t at = 0; at <= length; ++at) {
+            for (const auto &insert : inserts) {
+                for (const std::string prefix : { "", " ", "[", "{\"k\":" }) {
+                    const std::string suffix = prefix.empty() ? "" : (prefix[0] == '{') ? "}" : (prefix[0] == '[') ? "]" : " ";
+                    std::string text(length, 'a');
+                    text.insert(at, insert);
+                    corpus.push_back(prefix + "\"" + text + "\"" + suffix);
+                }
+            }
+            // unterminated, and a string as long as the text
+            corpus.push_back("\"" + std::string(at, 'b') + "\\");
+            corpus.push_back("\"" + std::string(at, 'b'));
+            corpus.push_back("{\"" + std::string(at, 'k') + "\":\"" + std::string(length - at, 'v') + "\"}");
+            // runs of whitespace between tokens
+            corpus.push_back("[" + std::string(at, ' ') + "1," + std::string(length - at, '\n') + "2]");
+            corpus.push_back("[" + std::string(at, ' ') + Text("\0") + std::string(length - at, ' ') + "1]");
+            corpus.push_back("[1]" + std::string(at, ' ') + "x");
+        }
+    }
+    // many short strings and numbers in a row
+    std::string strings{ "[" };
+    std::string numbers{ "[" };
+    for (size_t i = 0; i < 200; ++i) {
+        strings += (i > 0 ? ",\"" : "\"") + std::string(i % 37, 'x') + (i % 5 ? "" : "\\t") + "\"";
+        numbers += (i > 0 ? "," : "") + std::to_string(i * 7919) + (i % 3 ? "" : ".25e-3");
+    }
+    corpus.push_back(strings + "]");
+    corpus.push_back(numbers + "]");
+    return corpus;
+}
+
+int main()
+{
+    wxInitializer initializer;
+    if (!initializer.IsOk()) {
+        fprintf(stderr, "Failed to initialize wxWidgets.\n");
+        return EXIT_FAILURE;
+    }
+
+    const auto corpus = MakeCorpus();
+    for (const auto &text : corpus) {
+        CheckText(text);
+        CheckParallel(text);
+    }
+    const auto blockCorpus = MakeBlockCorpus();
+    for (const auto &text : blockCorpus) {
+        CheckText(text);
+    }
+
+    if (s_failures != 0) {
+        fprintf(stderr, "%zu parser checks failed.\n", s_failures);
+        return EXIT_FAILURE;
+    }
+    printf("%zu texts parsed the same as cJSON.\n", corpus.size() + blockCorpus.size());
+    return EXIT_SUCCESS;
+}